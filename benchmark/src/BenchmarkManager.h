@@ -0,0 +1,61 @@
+//
+//  BenchmarkManager.h
+//  ofxAnimationAssetManager benchmark
+//
+//  Drives single loading stages of ofxAnimationAssetManager without a GL context.
+//
+//
+
+#pragma once
+#include "ofxAnimationAssetManager.h"
+
+class BenchmarkManager : public ofxAnimationAssetManager{
+
+public:
+
+	//setup() minus the GL bits (the null texture)
+	void setupHeadless(int numThreads){
+		numThreadsToUse = std::max(numThreads, 1);
+		workers.setup(numThreadsToUse);
+		ofSetLogLevel("ofxDXT", OF_LOG_WARNING);
+		isSetup = true;
+	}
+
+	//runs CHECKING_ASSETS on all assets, without moving on to the next stage. Returns ms
+	float runCheck(){
+		uint64_t start = ofGetElapsedTimeMicros();
+		setState(CHECKING_ASSETS);
+		while(true){
+			numCheckTasks -= finishedChecks.drain([this](CheckInfo && r){
+				checked[r.ID] = std::move(r);
+			});
+			if(checked.size() == info.size()) break;
+			ofSleepMillis(1);
+		}
+		return (ofGetElapsedTimeMicros() - start) / 1000.0f;
+	}
+
+	//runs COMPRESSING_ASSETS on whatever the last runCheck() flagged. Returns ms
+	float runCompress(){
+		if(getNumAssetsToCompress() == 0) return 0; //setState() would jump to PRELOADING_ASSETS, which needs GL
+		uint64_t start = ofGetElapsedTimeMicros();
+		setState(COMPRESSING_ASSETS);
+		while(true){
+			numCompressTasks -= finishedCompressions.drain([](CompressInfo &&){});
+			if(numCompressTasks == 0) break;
+			ofSleepMillis(1);
+		}
+		stopCompressionPipeline();
+		return (ofGetElapsedTimeMicros() - start) / 1000.0f;
+	}
+
+	int getNumAssetsToCompress(){
+		int n = 0;
+		for(auto & it : checked) n += it.second.needsCompression ? 1 : 0;
+		return n;
+	}
+
+	static vector<int> plan(const vector<float> & sizes, const vector<float> & values, float capacity){
+		return solveKnapsack(sizes, values, capacity);
+	}
+};
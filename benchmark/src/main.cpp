@@ -0,0 +1,12 @@
+#include "ofMain.h"
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+//========================================================================
+int main(int argc, char * argv[]){
+
+	//no window, no GL context: only the stages that don't touch the GPU are benchmarked
+	auto win = make_shared<ofAppNoWindow>();
+	ofRunApp(win, make_shared<ofApp>(vector<string>(argv + 1, argv + argc)));
+	return ofRunMainLoop();
+}
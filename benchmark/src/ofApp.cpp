@@ -0,0 +1,289 @@
+#include "ofApp.h"
+
+
+ofApp::ofApp(const vector<string> & args){
+	parseArgs(args);
+}
+
+
+void ofApp::parseArgs(const vector<string> & args){
+
+	for(size_t i = 0; i + 1 < args.size(); i += 2){
+		const string & key = args[i];
+		const string & value = args[i + 1];
+		if(key == "--sequences") config.sequences = std::max(1, ofToInt(value));
+		else if(key == "--frames") config.frames = std::max(1, ofToInt(value));
+		else if(key == "--width") config.width = std::max(4, ofToInt(value));
+		else if(key == "--height") config.height = std::max(4, ofToInt(value));
+		else if(key == "--alpha") config.alpha = value;
+		else if(key == "--threads") config.maxThreads = std::max(1, ofToInt(value));
+		else if(key == "--out") config.out = value;
+		else ofLogWarning("benchmark") << "unknown option \"" << key << "\"";
+	}
+	if(config.alpha != "opaque" && config.alpha != "sparse" && config.alpha != "gradient"){
+		ofLogWarning("benchmark") << "unknown alpha mode \"" << config.alpha << "\", using \"sparse\"";
+		config.alpha = "sparse";
+	}
+	config.maxThreads = std::max(1, config.maxThreads);
+}
+
+
+void ofApp::setup(){
+
+	ofSetLogLevel(OF_LOG_NOTICE);
+	ofSetLogLevel("ofxAnimationAssetManager", OF_LOG_WARNING); //per asset chatter would skew the timings
+
+	generateSequences();
+
+	ofJson results;
+	results["version"] = 1;
+	results["config"]["sequences"] = config.sequences;
+	results["config"]["frames"] = config.frames;
+	results["config"]["width"] = config.width;
+	results["config"]["height"] = config.height;
+	results["config"]["alpha"] = config.alpha;
+	results["config"]["maxThreads"] = config.maxThreads;
+	results["config"]["totalFrames"] = totalFrames;
+	results["config"]["totalSourceMB"] = totalSourceBytes / float(1024 * 1024);
+
+	//the SIMD encoder has to match stb_dxt bit for bit, on random blocks and on whole images
+	auto simdLevel = ofxAnimationAssetManagerDxtEncoder::detectSimdLevel();
+	int mismatches = ofxAnimationAssetManagerDxtEncoder::verifyAgainstStb(simdLevel, 100000);
+	results["encoder"]["simdLevel"] = ofxAnimationAssetManagerDxtEncoder::toString(simdLevel);
+	results["encoder"]["mismatchedBlocks"] = mismatches;
+	ofPixels framePix;
+	fillFrame(framePix, 0, config.frames / 2);
+	auto noise = ofxAnimationAssetManagerDxtEncoder::benchmark(config.width, config.height, 5);
+	auto frame = ofxAnimationAssetManagerDxtEncoder::benchmark(framePix, 5);
+	results["encoder"]["noise"] = toJson(noise);
+	results["encoder"]["frame"] = toJson(frame);
+	bool encoderOk = mismatches == 0 && noise.bitExact && frame.bitExact;
+
+	vector<Run> runs;
+	for(int n : threadCounts(config.maxThreads)){
+		runs.push_back(runThreads(n));
+	}
+
+	//scaling efficiency: throughput at N threads / (throughput at 1 thread * N)
+	ofJson threads = ofJson::array();
+	for(auto & run : runs){
+		ofJson r;
+		r["threads"] = run.threads;
+		for(auto & it : run.stages){
+			ofJson s = toJson(it.second);
+			float base = runs.front().stages[it.first].framesPerSec * run.threads / float(runs.front().threads);
+			s["scalingEfficiency"] = base > 0 ? it.second.framesPerSec / base : 0.0f;
+			r["stages"][it.first] = s;
+		}
+		r["stats"] = run.stats;
+		threads.push_back(r);
+	}
+	results["threads"] = threads;
+	results["planner"] = runPlanner();
+
+	string out = results.dump(1);
+	cout << out << endl;
+	if(!ofSavePrettyJson(config.out, results)){
+		ofLogError("benchmark") << "can't write results to \"" << config.out << "\"";
+	}
+	clearCache();
+	if(!encoderOk){
+		ofLogError("benchmark") << "the SIMD DXT encoder doesn't match stb_dxt!";
+	}
+	ofExit(encoderOk ? 0 : 1);
+}
+
+
+vector<int> ofApp::threadCounts(int maxThreads){
+	vector<int> counts;
+	for(int n = 1; n < maxThreads; n *= 2) counts.push_back(n);
+	counts.push_back(maxThreads);
+	return counts;
+}
+
+
+ofApp::Throughput ofApp::throughput(float ms){
+	Throughput t;
+	t.ms = ms;
+	if(ms > 0){
+		t.framesPerSec = totalFrames / (ms / 1000.0f);
+		t.mbPerSec = totalSourceBytes / float(1024 * 1024) / (ms / 1000.0f);
+	}
+	return t;
+}
+
+
+ofJson ofApp::toJson(const Throughput & t){
+	ofJson j;
+	j["ms"] = t.ms;
+	j["framesPerSec"] = t.framesPerSec;
+	j["mbPerSec"] = t.mbPerSec;
+	return j;
+}
+
+
+ofJson ofApp::toJson(const ofxAnimationAssetManagerDxtEncoder::BenchmarkResult & r){
+	ofJson j;
+	j["width"] = r.width;
+	j["height"] = r.height;
+	j["ofxDxtMPixPerSec"] = r.ofxDxtMPixPerSec;
+	j["simdMPixPerSec"] = r.simdMPixPerSec;
+	j["speedup"] = r.simdMs > 0 ? r.ofxDxtMs / r.simdMs : 0.0;
+	j["bitExact"] = r.bitExact;
+	return j;
+}
+
+
+ofApp::Run ofApp::runThreads(int numThreads){
+
+	clearCache(); //every run starts from scratch
+
+	Run run;
+	run.threads = numThreads;
+
+	BenchmarkManager aam;
+	aam.setupHeadless(numThreads);
+	for(size_t i = 0; i < sequenceFolders.size(); i++){
+		string path = sequenceFolders[i];
+		ofxAnimationAssetManager::AssetLoadOptions options;
+		aam.addAsset("SEQ_" + ofToString(i), path, options);
+	}
+
+	run.stages["checkCold"] = throughput(aam.runCheck());
+	if(aam.getNumAssetsToCompress() != sequenceFolders.size()){
+		ofLogWarning("benchmark") << "expected all sequences to need compression, got " << aam.getNumAssetsToCompress();
+	}
+	run.stages["compress"] = throughput(aam.runCompress());
+	run.stats = aam.getStats().toJson();
+
+	aam.setCacheValidation(ofxAnimationAssetManager::VALIDATE_CACHE_FAST);
+	run.stages["checkWarm"] = throughput(aam.runCheck());
+	aam.setCacheValidation(ofxAnimationAssetManager::VALIDATE_CACHE_FULL);
+	run.stages["checkFullHash"] = throughput(aam.runCheck());
+
+	ofLogNotice("benchmark") << numThreads << " threads: check " << run.stages["checkCold"].ms << "ms, compress "
+		<< run.stages["compress"].ms << "ms (" << run.stages["compress"].framesPerSec << " frames/s), warm check "
+		<< run.stages["checkWarm"].ms << "ms, full hash check " << run.stages["checkFullHash"].ms << "ms";
+	return run;
+}
+
+
+ofJson ofApp::runPlanner(){
+
+	ofJson results = ofJson::array();
+	ofSeedRandom(1234);
+	for(int numItems : {10, 100, 1000}){
+		vector<float> sizes, values;
+		float total = 0;
+		for(int i = 0; i < numItems; i++){
+			sizes.push_back(ofRandom(1, 500)); //MB
+			values.push_back(sizes.back() * ofRandom(0.1, 10));
+			total += sizes.back();
+		}
+		const int iterations = 20;
+		vector<int> chosen;
+		uint64_t start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < iterations; i++){
+			chosen = BenchmarkManager::plan(sizes, values, total * 0.5);
+		}
+		float ms = (ofGetElapsedTimeMicros() - start) / 1000.0f / iterations;
+		float used = 0;
+		for(int i : chosen) used += sizes[i];
+
+		ofJson r;
+		r["items"] = numItems;
+		r["ms"] = ms;
+		r["budgetUsed"] = used / (total * 0.5);
+		results.push_back(r);
+	}
+	return results;
+}
+
+
+void ofApp::generateSequences(){
+
+	string root = ofToDataPath(config.dataFolder, true);
+	string stamp = ofToString(config.sequences) + " " + ofToString(config.frames) + " " + ofToString(config.width) + "x" + ofToString(config.height) + " " + config.alpha;
+	string stampPath = root + "/config.txt";
+
+	sequenceFolders.clear();
+	for(int s = 0; s < config.sequences; s++){
+		sequenceFolders.push_back(root + "/seq" + ofToString(s, 2, '0'));
+	}
+
+	//reuse the sequences of a previous run with the same config
+	ofBuffer existing = ofBufferFromFile(stampPath);
+	if(existing.getText() != stamp){
+		ofLogNotice("benchmark") << "generating " << config.sequences << " sequences of " << config.frames << " frames (" << stamp << ")";
+		ofDirectory::removeDirectory(root, true, false);
+		ofPixels pix;
+		for(int s = 0; s < config.sequences; s++){
+			ofDirectory::createDirectory(sequenceFolders[s], false, true);
+			for(int f = 0; f < config.frames; f++){
+				fillFrame(pix, s, f);
+				ofSaveImage(pix, sequenceFolders[s] + "/frame_" + ofToString(f, 5, '0') + ".png");
+			}
+		}
+		ofBufferToFile(stampPath, ofBuffer(stamp.c_str(), stamp.size()));
+	}
+
+	totalFrames = 0;
+	totalSourceBytes = 0;
+	for(auto & folder : sequenceFolders){
+		ofDirectory dir;
+		dir.allowExt("png");
+		dir.listDir(folder);
+		totalFrames += dir.size();
+		for(size_t i = 0; i < dir.size(); i++){
+			totalSourceBytes += dir.getFile(i).getSize();
+		}
+	}
+}
+
+
+void ofApp::fillFrame(ofPixels & pix, int sequence, int frame){
+
+	int w = config.width;
+	int h = config.height;
+	pix.allocate(w, h, OF_PIXELS_RGBA);
+	unsigned char * data = pix.getData();
+
+	//a disc moving around, over a drifting pattern with a bit of noise so frames don't compress to nothing
+	float t = frame / float(config.frames);
+	float cx = w * (0.5 + 0.3 * cos(TWO_PI * t + sequence));
+	float cy = h * (0.5 + 0.3 * sin(TWO_PI * t + sequence));
+	float radius = std::min(w, h) * 0.2;
+
+	for(int y = 0; y < h; y++){
+		for(int x = 0; x < w; x++){
+			unsigned char * p = data + (size_t(y) * w + x) * 4;
+			uint32_t noise = (uint32_t(x) * 73856093u ^ uint32_t(y) * 19349663u ^ uint32_t(frame) * 83492791u) >> 28;
+			p[0] = (x + frame * 3) & 255;
+			p[1] = (y + sequence * 40) & 255;
+			p[2] = ((x ^ y) + frame + noise) & 255;
+			bool inside = (x - cx) * (x - cx) + (y - cy) * (y - cy) < radius * radius;
+			if(config.alpha == "opaque"){
+				p[3] = 255;
+			}else if(config.alpha == "gradient"){
+				p[3] = x * 255 / std::max(1, w - 1);
+			}else{ //sparse: mostly fully transparent canvas
+				p[3] = inside ? 255 : 0;
+				if(!inside) p[0] = p[1] = p[2] = 0;
+			}
+		}
+	}
+}
+
+
+void ofApp::clearCache(){
+
+	for(auto & folder : sequenceFolders){
+		ofDirectory dir;
+		dir.allowExt("dxt");
+		dir.listDir(folder);
+		for(size_t i = 0; i < dir.size(); i++){
+			ofFile::removeFile(dir.getPath(i), false);
+		}
+		ofFile::removeFile(folder + "/" + ofxAnimationAssetManagerManifest::fileName, false);
+	}
+}
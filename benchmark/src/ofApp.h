@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ofMain.h"
+#include "BenchmarkManager.h"
+
+// Headless benchmark of ofxAnimationAssetManager's loading stages.
+//
+// Generates synthetic PNG sequences, then runs checking (cold cache, warm cache
+// and full re-hash) and compression at 1..N threads, and times the preload
+// planner. Results go to stdout and to a JSON file so they can be diffed across
+// releases. See README.md for the command line options.
+
+class ofApp : public ofBaseApp{
+
+public:
+
+	ofApp(const vector<string> & args);
+	void setup();
+
+protected:
+
+	struct Config{
+		int sequences = 4;			//number of animations
+		int frames = 60;			//frames per animation
+		int width = 512;
+		int height = 512;
+		string alpha = "sparse";	//opaque | sparse (shape over a transparent canvas) | gradient
+		int maxThreads = std::thread::hardware_concurrency();
+		string out = "benchmark.json";
+		string dataFolder = "synthetic";
+	};
+
+	struct Throughput{
+		float ms = 0;
+		float framesPerSec = 0;
+		float mbPerSec = 0; //MB of source images processed per second
+	};
+
+	struct Run{
+		int threads = 1;
+		map<string, Throughput> stages; //checkCold, compress, checkWarm, checkFullHash
+		ofJson stats; //getStats() after compressing
+	};
+
+	Config config;
+	vector<string> sequenceFolders;
+	int totalFrames = 0;
+	uint64_t totalSourceBytes = 0;
+
+	void parseArgs(const vector<string> & args);
+	void generateSequences();
+	void fillFrame(ofPixels & pix, int sequence, int frame);
+	void clearCache();
+
+	Run runThreads(int numThreads);
+	ofJson runPlanner();
+	Throughput throughput(float ms);
+	static ofJson toJson(const Throughput & t);
+	static ofJson toJson(const ofxAnimationAssetManagerDxtEncoder::BenchmarkResult & r);
+	static vector<int> threadCounts(int maxThreads);
+};
@@ -220,6 +220,10 @@ void ofApp::keyPressed(int key){
 	}
 
 
+	if(key == 'j'){ //dump loading stats
+		ofSavePrettyJson("ofxAnimationAssetManagerStats.json", aam.getStats().toJson());
+	}
+
 	if(key == OF_KEY_RIGHT || key == OF_KEY_DOWN){
 		selectedAsset ++;
 		if(selectedAsset > allAssetIDs.size() - 1) selectedAsset = 0;
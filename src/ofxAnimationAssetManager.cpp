@@ -22,25 +22,9 @@ ofxAnimationAssetManager::ofxAnimationAssetManager(){}
 
 ofxAnimationAssetManager::~ofxAnimationAssetManager(){
 
-	needsToStop = true;
-
-	//wait for all threads to end
-	for(int i = checkTasks.size() - 1; i >= 0; i--){
-		std::future_status status = checkTasks[i].wait_for(std::chrono::microseconds(0));
-		while(status != std::future_status::ready){
-			ofSleepMillis(16);
-			status = checkTasks[i].wait_for(std::chrono::microseconds(0));
-		}
-	}
-
-	//wait for all threads to end
-	for(int i = compressTasks.size() - 1; i >= 0; i--){
-		std::future_status status = compressTasks[i].wait_for(std::chrono::microseconds(0));
-		while(status != std::future_status::ready){
-			ofSleepMillis(16);
-			status = compressTasks[i].wait_for(std::chrono::microseconds(0));
-		}
-	}
+	if(cancelToken) *cancelToken = true;
+	stopCompressionPipeline();
+	workers.stop(); //wait for all threads to end
 }
 
 
@@ -51,20 +35,22 @@ string ofxAnimationAssetManager::getStatus(){
 
 	if(state == CHECKING_ASSETS){
 		for(auto & it : checkProgress){
-			if(it.second.pct < 1.0f ){
-				list += "  " + it.first + ": " + ofToString(100 * it.second.pct, 1) + "% done \n";
+			float pct = it.second->pct;
+			if(pct < 1.0f ){
+				list += "  " + it.first + ": " + ofToString(100 * pct, 1) + "% done \n";
 			}
 		}
-		msg += ofToString(checked.size()) + "/" + ofToString(pendingCheck.size() + checked.size() + checkTasks.size()) + " [" + ofToString(checkTasks.size()) + " active tasks]";
+		msg += ofToString(checked.size()) + "/" + ofToString(checked.size() + numCheckTasks) + " [" + ofToString(workers.getNumActiveJobs()) + " active tasks]";
 		msg += "\n" + list;
 	}
 	if(state == COMPRESSING_ASSETS){
 		for(auto & it : compressProgress){
-			if(it.second.pct < 1.0f){
-				list += "  " + it.first + ": " + ofToString(100 * it.second.pct, 1) + "% done \n";
+			float pct = it.second->pct;
+			if(pct < 1.0f){
+				list += "  " + it.first + ": " + ofToString(100 * pct, 1) + "% done \n";
 			}
 		}
-		msg += ofToString(compressed.size()) + "/" + ofToString(pendingCompression.size() + compressed.size() + compressTasks.size()) + " [" + ofToString(compressTasks.size()) + " active tasks]";
+		msg += ofToString(compressed.size()) + "/" + ofToString(compressed.size() + numCompressTasks) + " [" + ofToString(workers.getNumActiveJobs()) + " active tasks]";
 		msg += "\n" + list;
 	}
 	return msg;
@@ -128,10 +114,12 @@ void ofxAnimationAssetManager::setup(const string & folder, float maxUsedVRAM, c
 
 void ofxAnimationAssetManager::setup(float maxUsedVRAM, int numThreads, bool playAssetsInReverse) {
 
-	numThreadsToUse = numThreads;
+	numThreadsToUse = std::max(numThreads, 1);
 	this->maxUsedVRAM = maxUsedVRAM;
 	this->playAssetsInReverse = playAssetsInReverse;
 
+	workers.setup(numThreadsToUse);
+
 	ofSetLogLevel("ofxDXT", OF_LOG_WARNING); //silence notice or lower logs for the extra-chatty ofxDXT
 
 	//init null texture to RED
@@ -175,28 +163,13 @@ bool ofxAnimationAssetManager::addAsset(string ID, string& path) {
 	ofDirectory dir;
 	dir.open(path);
 
-	// If this is a directory and it contains more than 1 valid image, mark it as an animation
+	// If this is a directory, mark it as an animation. Its check job lists it, off the main thread, and
+	// turns it into a static image if it only holds one (or leaves it out if it holds none)
 	if (dir.isDirectory()) { 
-		dir.allowExt("png");
-		dir.allowExt("tga");
-		dir.listDir();
-		if (dir.size() == 0) {			// invalid
-			ofLogNotice("ofxAnimationAssetManager") << "can't load ANIMATION with ID \"" << ID << "\" because there are insufficient PNG or TGA files";
-			return false;
-		}
-		else if (dir.size() == 1) {		// image
-			// Load a single image inside this folder
-			info[ID].type = STATIC_IMAGE;
-			info[ID].fullPath = dir.getPath(0);
-			ofLogVerbose("ofxAnimationAssetManager") << "found STATIC_IMAGE with ID \"" << ID << "\"";
-			return true;
-		}
-		else {							// animation
-			info[ID].type = ANIMATION;
-			info[ID].fullPath = path;
-			ofLogVerbose("ofxAnimationAssetManager") << "found ANIMATION with ID \"" << ID << "\"";
-			return true;
-		}
+		info[ID].type = ANIMATION;
+		info[ID].fullPath = path;
+		ofLogVerbose("ofxAnimationAssetManager") << "found ANIMATION with ID \"" << ID << "\"";
+		return true;
 	}
 	else {								// image
 		string extension = ofFilePath::getFileExt(path);
@@ -221,8 +194,42 @@ void ofxAnimationAssetManager::startLoading(){
 }
 
 
+void ofxAnimationAssetManager::cancelLoading(){
+
+	if(state == UNINITED || state == READY) return;
+	ofLogNotice("ofxAnimationAssetManager") << "cancelling loading at " << toString(state);
+
+	if(cancelToken) *cancelToken = true;
+	stopCompressionPipeline(); //joins the reader & writer
+	workers.cancelPending(); //drops queued jobs, waits for the running ones (they bail out on the token)
+
+	//forget about the unfinished stage
+	numCheckTasks = 0;
+	numCompressTasks = 0;
+	numPendingDecodes = 0;
+	finishedChecks.clear();
+	finishedCompressions.clear();
+	finishedDecodes.clear();
+	pendingUploads.clear();
+	pendingPreload.clear();
+	finishedPrefetches.clear();
+	cuedPrefetches.clear();
+	prefetchQueue = decltype(prefetchQueue)();
+	numPrefetchJobs = 0;
+	setState(UNINITED);
+}
+
+
+void ofxAnimationAssetManager::restartLoading(){
+
+	cancelLoading();
+	startLoading();
+}
+
+
 void ofxAnimationAssetManager::setState(State s){
 
+	onStageChange(state, s);
 	state = s;
 
 	switch (s) {
@@ -230,24 +237,62 @@ void ofxAnimationAssetManager::setState(State s){
 
 		case CHECKING_ASSETS:
 			ofLogNotice("ofxAnimationAssetManager") << "## Start CHECKING Assets #########################################################";
-			pendingCheck.clear();
+			cancelToken = make_shared<std::atomic<bool>>(false);
 			checked.clear();
+			checkProgress.clear();
+			for(auto & it : info){ //create all progress slots, counters & options before any worker can read / write them
+				if(assetLoadOptions.find(it.first) == assetLoadOptions.end()){
+					if(it.second.type == ANIMATION){
+						ofLogWarning("ofxAnimationAssetManager") << "Found asset in Folder but user did not supply AssetLoadOptions for it! (" << it.first << "). Will use default options";
+					}
+					assetLoadOptions[it.first] = AssetLoadOptions();
+				}
+				checkProgress[it.first] = make_shared<ProgressInfo>();
+				counters[it.first] = unique_ptr<AssetCounters>(new AssetCounters());
+				//set again once checked / baked if this load's frames are trimmed; a previous load's rect doesn't apply
+				it.second.isTrimmed = false;
+				it.second.trimRect = ofRectangle();
+			}
 			for(auto & it : info){
-				pendingCheck.push_back(it.first);
+				string id = it.first;
+				shared_ptr<ProgressInfo> progress = checkProgress[id];
+				CancelToken cancel = cancelToken;
+				numCheckTasks++;
+				workers.submit([this, id, progress, cancel](){
+					if(isCancelled(cancel)) return;
+					uint64_t start = ofGetElapsedTimeMicros();
+					CheckInfo results = checkAsset(id, progress, cancel);
+					getCounters(id)->checkMicros = ofGetElapsedTimeMicros() - start;
+					if(isCancelled(cancel)) return;
+					finishedChecks.push(std::move(results));
+				});
 			}
 			break;
 			
 		case COMPRESSING_ASSETS:
 			ofLogNotice("ofxAnimationAssetManager") << "## Start COMPRESSING Assets ######################################################";
-			pendingCompression.clear();
 			compressed.clear();
+			compressProgress.clear();
 			for(auto & it : checked){
 				if(it.second.needsCompression){
-					pendingCompression.push_back(it.first);
+					compressProgress[it.first] = make_shared<ProgressInfo>();
 				}
 			}
-			if(pendingCompression.size() == 0){ //if nobody need compression, skip stage
+			if(compressProgress.size() == 0){ //if nobody need compression, skip stage
 				setState(PRELOADING_ASSETS);
+				break;
+			}
+			startCompressionPipeline();
+			for(auto & it : compressProgress){
+				string id = it.first;
+				shared_ptr<ProgressInfo> progress = it.second;
+				CancelToken cancel = cancelToken;
+				vector<string> frames = checked[id].framesToCompress;
+				numCompressTasks++;
+				workers.submit([this, id, progress, cancel, frames](){
+					if(isCancelled(cancel)) return;
+					compressAsset(id, progress, cancel, frames);
+				});
 			}
 			break;
 
@@ -260,20 +305,34 @@ void ofxAnimationAssetManager::setState(State s){
 				int numFrames;
 			};
 
+			for(auto & it : info){ //LODs first, everything below is sized from the frames they load
+				if(it.second.type == ANIMATION){
+					auto & opt = assetLoadOptions[it.first];
+					it.second.lodLevel = pickLodLevel(it.first, opt.drawWidth, opt.drawHeight);
+					if(it.second.lodLevel > 0){
+						ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << it.first << "\" will load LOD " << it.second.lodLevel << " for a " << opt.drawWidth << "x" << opt.drawHeight << " draw size.";
+					}
+				}
+			}
+
+			planAdaptiveBuffers(); //before the animations get set up with their buffer sizes
+			adaptiveAnimations.clear();
+
 			//lets store all the anims and their estimated preload size
 			//the goal here is to automatically decide what to preload in VRAM and what to stream
 			//given how much memory we can use.
 			vector<AnimInfo> animInfos;
+			vector<string> staticImageIDs;
 
 			for(auto & it : info){
 
 				if(it.second.type == STATIC_IMAGE){
 
-					pendingPreload.push_back(it.first); //all static images get preloaded
+					staticImageIDs.push_back(it.first); //all static images get preloaded
 					info[it.first].isPreloaded = true;
 					info[it.first].useDxtCompression = false; //static images never compressed
 
-				}else{ //for animations, we need to decide if we preload or not
+				}else if(it.second.type == ANIMATION){ //for animations, we need to decide if we preload or not
 
 					auto option = assetLoadOptions.find(it.first);
 					if(option == assetLoadOptions.end()){
@@ -289,9 +348,12 @@ void ofxAnimationAssetManager::setState(State s){
 
 					info[it.first].useDxtCompression = useDXTcompression;
 					animations[it.first].setup(numThreads, bufferFrames, useDXTcompression, playAssetsInReverse);
+					if(option->second.adaptiveBuffering){
+						adaptiveAnimations.push_back(AdaptiveAnimation{it.first, &animations[it.first], &info[it.first], &option->second, bufferFrames, numThreads});
+					}
     
-					animations[it.first].loadImageSequence(info[it.first].fullPath, framerate);
-					auto estimatedSizeBytes = animations[it.first].getEstimatdVramUse();
+					animations[it.first].loadImageSequence(getFramesFolder(it.first), framerate);
+					auto estimatedSizeBytes = estimateAnimationVRAM(it.first);
 
 					animations[it.first].setLoop(true);
 					animations[it.first].setKeepTexturesInGpuMem(false); //default to no, will set to true later if requested (in preload stage)
@@ -304,52 +366,117 @@ void ofxAnimationAssetManager::setState(State s){
 				}
 			}
 
-			//sort all anim info by size, smallest first
-			std::sort(animInfos.begin(), animInfos.end(),
-					  [](const AnimInfo & a, const AnimInfo & b) -> bool{
-						  return a.estimatedSizeFullSequence < b.estimatedSizeFullSequence;
-					  });
-
 			//now let's calculate who is preloaded in VRAM and who is to be streamed given how much
 			//VRAM we can use (maxUsedVRAM)
 
 			float memUsedByStaticImages = 0;
-			for(auto & id : pendingPreload){ //first lets calculate how much memory the static images take
-				int w, h, numChannels;
-				bool imgOK;
-				ofxImageSequenceVideo::getImageInfo(info[id].fullPath, w, h, numChannels, imgOK);
-				if(imgOK){
-					memUsedByStaticImages += ( w * h * numChannels / float(1024 * 1024));
-				}
+			for(auto & id : staticImageIDs){ //first lets calculate how much memory the static images take
+				AssetInfo & i = info[id]; //probed while checking
+				i.estimatedSize = i.estimatedFrameSize = i.sourceWidth * i.sourceHeight * i.numChannels / float(1024 * 1024);
 			}
+			buildAtlases(staticImageIDs); //packed images take no VRAM of their own, their atlas does
+			for(auto & id : staticImageIDs){
+				memUsedByStaticImages += info[id].estimatedSize;
+			}
+			memUsedByStaticImages += atlasVRAM;
 
 			ofLogVerbose("ofxAnimationAssetManager") << "Static Images will take " << memUsedByStaticImages << " Mb in VRAM.";
 			float memUsedByAllAnimationsSingleFrame = 0;
 			for(auto & anim : animInfos){
-				float mb = anim.estimatedSizeFullSequence / anim.numFrames;
+				float mb = anim.numFrames > 0 ? anim.estimatedSizeFullSequence / anim.numFrames : 0;
+				info[anim.ID].estimatedFrameSize = mb;
 				//ofLogNotice("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" one frame takes " << mb << " Mb of Vram.";
 				memUsedByAllAnimationsSingleFrame += mb;
 			}
 
 			float availableMemForAnimationsPreload = maxUsedVRAM - memUsedByStaticImages - memUsedByAllAnimationsSingleFrame;
 
-			//start by preloading the smallest animations, keep adding to the "pool" until we are out of space
+			preloadPlan = PreloadPlan();
+			preloadPlan.budget = std::max(0.0f, availableMemForAnimationsPreload);
+
+			//user forced animations go first, and they eat into the budget too
+			vector<AnimInfo> candidates;
 			for(auto & anim : animInfos){
-				if(assetLoadOptions[anim.ID].shouldPreloadAsset == DONT_CARE){
-					if(availableMemForAnimationsPreload - anim.estimatedSizeFullSequence > 0){
-						availableMemForAnimationsPreload -= anim.estimatedSizeFullSequence;
-						pendingPreload.push_back(anim.ID);
-						ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" will be preloaded because there's enough VRAM to fit it. " << availableMemForAnimationsPreload << " Mb left to use.";
-					}
+				auto & opt = assetLoadOptions[anim.ID];
+				if(opt.shouldPreloadAsset == YES){
+					availableMemForAnimationsPreload -= anim.estimatedSizeFullSequence;
+					preloadPlan.used += anim.estimatedSizeFullSequence;
+					preloadPlan.value += opt.playFrequency * opt.streamCost * anim.estimatedSizeFullSequence;
+					preloadPlan.preloaded.push_back(anim.ID);
+					ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" will be preloaded because of user config requesting it.";
+				}else if(opt.shouldPreloadAsset == NO){
+					preloadPlan.streamed.push_back(anim.ID);
+					ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" will be NOT BE preloaded because of user config requesting it.";
 				}else{
-					if(assetLoadOptions[anim.ID].shouldPreloadAsset == YES){
-						pendingPreload.push_back(anim.ID);
-						ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" will be preloaded because of user config requesting it.";
-					}else{
-						ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << anim.ID << "\" will be NOT BE preloaded because of user config requesting it.";
-					}
+					candidates.push_back(anim);
 				}
 			}
+			if(availableMemForAnimationsPreload < 0){
+				ofLogWarning("ofxAnimationAssetManager") << "Animations forced to preload exceed the VRAM budget by " << -availableMemForAnimationsPreload << " Mb!";
+			}
+
+			//pick the set of remaining animations that gets the most value out of the budget. The value of preloading
+			//an animation is how often it plays * how costly it is to stream * how much it would have to stream.
+			//Held frames are only linked on disk, the player still loads & uploads every one of them, so the
+			//full size counts on both sides
+			vector<float> sizes, values;
+			for(auto & anim : candidates){
+				auto & opt = assetLoadOptions[anim.ID];
+				sizes.push_back(anim.estimatedSizeFullSequence);
+				values.push_back(opt.playFrequency * opt.streamCost * anim.estimatedSizeFullSequence);
+			}
+			vector<int> chosen = solveKnapsack(sizes, values, std::max(0.0f, availableMemForAnimationsPreload));
+			vector<bool> isChosen(candidates.size(), false);
+			for(int i : chosen) isChosen[i] = true;
+
+			for(int i = 0; i < candidates.size(); i++){
+				if(isChosen[i]){
+					preloadPlan.used += sizes[i];
+					preloadPlan.value += values[i];
+					preloadPlan.preloaded.push_back(candidates[i].ID);
+					ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << candidates[i].ID << "\" will be preloaded (" << sizes[i] << " Mb).";
+				}else{
+					preloadPlan.streamed.push_back(candidates[i].ID);
+					ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << candidates[i].ID << "\" will be streamed (" << sizes[i] << " Mb didn't make the cut).";
+				}
+			}
+			preloadPlan.leftover = std::max(0.0f, preloadPlan.budget - preloadPlan.used);
+			pendingPreload.insert(pendingPreload.end(), preloadPlan.preloaded.begin(), preloadPlan.preloaded.end());
+
+			ofLogNotice("ofxAnimationAssetManager") << "VRAM plan: preloading " << preloadPlan.preloaded.size() << " animations (" << preloadPlan.used << " Mb), streaming "
+				<< preloadPlan.streamed.size() << ". " << preloadPlan.leftover << " Mb of " << preloadPlan.budget << " Mb budget left unused.";
+
+			//decode all static images in the background, update() uploads them as they come in
+			for(auto & id : staticImageIDs){
+				string path = info[id].fullPath;
+				CancelToken cancel = cancelToken;
+				Atlas * atlas = info[id].atlasIndex >= 0 ? atlases[info[id].atlasIndex].get() : nullptr;
+				ofRectangle rect = info[id].atlasRect;
+				numPendingDecodes++;
+				workers.submit([this, id, path, cancel, atlas, rect](){
+					if(isCancelled(cancel)) return;
+					DecodedImage img;
+					img.ID = id;
+					uint64_t start = ofGetElapsedTimeMicros();
+					if(!ofLoadImage(img.pixels, path)){
+						ofLogError("ofxAnimationAssetManager") << "can't load static image \"" << id << "\" at \"" << path << "\"";
+					}else if(img.pixels.isAllocated()){
+						decodeLatency.add(ofGetElapsedTimeMicros() - start);
+						uint64_t size;
+						int64_t modified;
+						if(ofxAnimationAssetManagerManifest::getFileStats(path, size, modified)){
+							getCounters(id)->bytesRead += size;
+						}
+						if(atlas){ //each image has its own rect, so workers can paste side by side
+							img.pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+							img.pixels.pasteInto(atlas->pixels, rect.x, rect.y);
+							img.pixels.clear();
+						}
+					}
+					if(isCancelled(cancel)) return;
+					finishedDecodes.push(std::move(img));
+				});
+			}
 			}break;
 
 		default:
@@ -358,10 +485,159 @@ void ofxAnimationAssetManager::setState(State s){
 }
 
 
+vector<int> ofxAnimationAssetManager::solveKnapsack(const vector<float> & sizes, const vector<float> & values, float capacity){
+
+	vector<int> chosen;
+	int n = sizes.size();
+	if(n == 0 || capacity <= 0) return chosen;
+
+	//discretize the capacity into at most this many cells; item sizes get rounded up so the
+	//solution never goes over budget
+	const int maxCells = 4096;
+	int numCells = std::min(maxCells, std::max(1, int(ceil(capacity))));
+	float cellSize = capacity / numCells;
+
+	vector<int> weights(n);
+	for(int i = 0; i < n; i++){
+		weights[i] = std::max(1, int(ceil(sizes[i] / cellSize)));
+	}
+
+	vector<float> best(numCells + 1, 0.0f);
+	vector<unsigned char> taken(size_t(n) * (numCells + 1), 0);
+	for(int i = 0; i < n; i++){
+		if(weights[i] > numCells) continue;
+		for(int c = numCells; c >= weights[i]; c--){
+			float v = best[c - weights[i]] + values[i];
+			if(v > best[c]){
+				best[c] = v;
+				taken[size_t(i) * (numCells + 1) + c] = 1;
+			}
+		}
+	}
+
+	//walk back the decisions
+	int c = numCells;
+	for(int i = n - 1; i >= 0; i--){
+		if(taken[size_t(i) * (numCells + 1) + c]){
+			chosen.push_back(i);
+			c -= weights[i];
+		}
+	}
+	std::reverse(chosen.begin(), chosen.end());
+	return chosen;
+}
+
+
+float ofxAnimationAssetManager::getPreloadTimeBudget(){
+	if(preloadTimeBudgetMS > 0) return preloadTimeBudgetMS;
+	float fps = ofGetTargetFrameRate();
+	if(fps <= 0) fps = 60;
+	return 0.5 * 1000.0 / fps;
+}
+
+
+void ofxAnimationAssetManager::activate(const string & ID){
+	AssetInfo & i = info[ID];
+	if(i.isActive || i.type != ANIMATION) return;
+	i.isActive = true;
+	activeAnimations.push_back(ActiveAnimation{&animations[ID], &i});
+}
+
+
+void ofxAnimationAssetManager::setResidencyManagement(bool enabled, float checkIntervalSec, float hotAfterSec, float coldAfterSec){
+	residencyEnabled = enabled;
+	residencyCheckIntervalMS = checkIntervalSec * 1000;
+	hotAfterMS = hotAfterSec * 1000;
+	coldAfterMS = coldAfterSec * 1000;
+}
+
+
+float ofxAnimationAssetManager::getResidentVRAM(){
+	float mb = atlasVRAM;
+	for(auto & it : info){
+		mb += it.second.isPreloaded ? it.second.estimatedSize : it.second.estimatedFrameSize;
+	}
+	return mb;
+}
+
+
+void ofxAnimationAssetManager::promote(const string & ID){
+	ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << ID << "\" is hot, preloading it in VRAM (" << info[ID].estimatedSize << " Mb).";
+	animations[ID].setKeepTexturesInGpuMem(true);
+	info[ID].isPreloaded = true;
+	activate(ID); //so it gets updated while it uploads its frames
+}
+
+
+void ofxAnimationAssetManager::evict(const string & ID){
+	ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << ID << "\" is cold, evicting it from VRAM (" << info[ID].estimatedSize << " Mb).";
+	animations[ID].setKeepTexturesInGpuMem(false);
+	animations[ID].eraseAllTextureCache();
+	info[ID].isPreloaded = false;
+}
+
+
+void ofxAnimationAssetManager::updateResidency(){
+
+	if(!residencyEnabled) return;
+	if(lastUpdateTimeMS - lastResidencyCheckMS < residencyCheckIntervalMS) return;
+	lastResidencyCheckMS = lastUpdateTimeMS;
+
+	auto isManaged = [this](const string & ID){
+		return info[ID].type == ANIMATION && assetLoadOptions[ID].shouldPreloadAsset == DONT_CARE;
+	};
+
+	//preloaded animations we could evict, least recently used first
+	vector<string> evictable;
+	for(auto & it : info){
+		if(it.second.isPreloaded && isManaged(it.first)) evictable.push_back(it.first);
+	}
+	std::sort(evictable.begin(), evictable.end(), [this](const string & a, const string & b){
+		return info[a].lastAccessMS < info[b].lastAccessMS;
+	});
+
+	float used = getResidentVRAM();
+
+	//over budget (ie after forced preloads or a promotion that was estimated too low), evict until we fit
+	while(used > maxUsedVRAM && evictable.size()){
+		string ID = evictable.front();
+		evictable.erase(evictable.begin());
+		evict(ID);
+		used -= info[ID].estimatedSize - info[ID].estimatedFrameSize;
+	}
+
+	//the most recently used streamed animation that's hot gets promoted, if we can make room for it.
+	//One per check, as preloading a whole sequence is not cheap
+	string hottest;
+	for(auto & it : info){
+		if(!it.second.isPreloaded && isManaged(it.first) && lastUpdateTimeMS - it.second.lastAccessMS <= hotAfterMS && it.second.lastAccessMS > 0){
+			if(hottest.empty() || it.second.lastAccessMS > info[hottest].lastAccessMS) hottest = it.first;
+		}
+	}
+	if(hottest.empty()) return;
+
+	float needed = info[hottest].estimatedSize - info[hottest].estimatedFrameSize;
+	float reclaimable = 0;
+	vector<string> victims;
+	for(auto & ID : evictable){
+		if(used + needed - reclaimable <= maxUsedVRAM) break;
+		if(lastUpdateTimeMS - info[ID].lastAccessMS < coldAfterMS) break; //sorted, the rest are even warmer
+		victims.push_back(ID);
+		reclaimable += info[ID].estimatedSize - info[ID].estimatedFrameSize;
+	}
+	if(used + needed - reclaimable <= maxUsedVRAM){
+		for(auto & ID : victims) evict(ID);
+		promote(hottest);
+	}
+}
+
+
 ofxImageSequenceVideo & ofxAnimationAssetManager::getAnimation(const string & ID){
 	auto it = info.find(ID);
 	if(it != info.end()){
 		if(it->second.type == ANIMATION){
+			it->second.lastAccessMS = it->second.lastTouchMS = lastUpdateTimeMS;
+			if(!it->second.isActive) activate(ID);
 			return animations[ID];
 		}else{
 			ofLogError("ofxAnimationAssetManager") << "getAnimation() error! requested animation \"" << ID << "\" is a static image!";
@@ -377,7 +653,9 @@ ofxImageSequenceVideo & ofxAnimationAssetManager::getAnimation(const string & ID
 ofTexture & ofxAnimationAssetManager::getTexture(const string & ID){
 	auto it = info.find(ID);
 	if(it != info.end()){
+		it->second.lastAccessMS = lastUpdateTimeMS;
 		if(it->second.type == STATIC_IMAGE){
+			if(it->second.atlasIndex >= 0) return atlases[it->second.atlasIndex]->texture;
 			return images[ID];
 		}else{
 			return animations[ID].getTexture();
@@ -387,6 +665,374 @@ ofTexture & ofxAnimationAssetManager::getTexture(const string & ID){
 	return nullTexture;
 }
 
+ofxAnimationAssetManager::AtlasRegion ofxAnimationAssetManager::getAtlasRegion(const string & ID){
+
+	AtlasRegion r;
+	auto it = info.find(ID);
+	if(it == info.end() || it->second.type != STATIC_IMAGE) return r;
+	it->second.lastAccessMS = lastUpdateTimeMS;
+	if(it->second.atlasIndex >= 0){
+		r.texture = &atlases[it->second.atlasIndex]->texture;
+		r.rect = it->second.atlasRect;
+	}else{
+		r.texture = &images[ID];
+		r.rect = ofRectangle(0, 0, r.texture->getWidth(), r.texture->getHeight());
+	}
+	float w = r.texture->getWidth();
+	float h = r.texture->getHeight();
+	if(w > 0 && h > 0){
+		r.uv = ofRectangle(r.rect.x / w, r.rect.y / h, r.rect.width / w, r.rect.height / h);
+	}
+	return r;
+}
+
+
+void ofxAnimationAssetManager::drawImage(const string & ID, float x, float y, float w, float h){
+	AtlasRegion r = getAtlasRegion(ID);
+	if(r.texture && r.texture->isAllocated()){
+		r.texture->drawSubsection(x, y, w, h, r.rect.x, r.rect.y, r.rect.width, r.rect.height);
+	}
+}
+
+
+void ofxAnimationAssetManager::setAtlasing(bool enabled, int maxImageSize, int atlasSize){
+	atlasingEnabled = enabled;
+	maxAtlasImageSize = std::max(1, maxImageSize);
+	this->atlasSize = std::max(maxAtlasImageSize, atlasSize);
+}
+
+
+void ofxAnimationAssetManager::buildAtlases(const vector<string> & staticImageIDs){
+
+	atlases.clear();
+	atlasVRAM = 0;
+	for(auto & id : staticImageIDs) info[id].atlasIndex = -1;
+	if(!atlasingEnabled) return;
+
+	vector<string> small;
+	for(auto & id : staticImageIDs){
+		AssetInfo & i = info[id];
+		if(i.sourceWidth > 0 && i.sourceWidth <= maxAtlasImageSize && i.sourceHeight > 0 && i.sourceHeight <= maxAtlasImageSize){
+			small.push_back(id);
+		}
+	}
+	if(small.size() < 2) return; //nothing to gain
+
+	//shelf packing, tallest first
+	std::sort(small.begin(), small.end(), [this](const string & a, const string & b){
+		if(info[a].sourceHeight != info[b].sourceHeight) return info[a].sourceHeight > info[b].sourceHeight;
+		return info[a].sourceWidth > info[b].sourceWidth;
+	});
+	const int padding = 2; //keeps linear filtering from bleeding the neighbours in
+	int x = 0, y = 0, shelfHeight = 0;
+	vector<int> usedWidth, usedHeight;
+	float unpackedMB = 0;
+	for(auto & id : small){
+		AssetInfo & i = info[id];
+		if(x + i.sourceWidth > atlasSize){ //next shelf
+			x = 0;
+			y += shelfHeight + padding;
+			shelfHeight = 0;
+		}
+		if(atlases.empty() || y + i.sourceHeight > atlasSize){ //next atlas
+			atlases.push_back(unique_ptr<Atlas>(new Atlas()));
+			usedWidth.push_back(0);
+			usedHeight.push_back(0);
+			x = y = shelfHeight = 0;
+		}
+		i.atlasIndex = atlases.size() - 1;
+		i.atlasRect.set(x, y, i.sourceWidth, i.sourceHeight);
+		atlases.back()->pendingImages++;
+		usedWidth.back() = std::max(usedWidth.back(), x + i.sourceWidth);
+		usedHeight.back() = std::max(usedHeight.back(), y + i.sourceHeight);
+		x += i.sourceWidth + padding;
+		shelfHeight = std::max(shelfHeight, i.sourceHeight);
+		unpackedMB += i.estimatedSize;
+		i.estimatedSize = i.estimatedFrameSize = 0;
+	}
+
+	//atlases are only as big as what they hold
+	for(int a = 0; a < atlases.size(); a++){
+		int w = (usedWidth[a] + 3) / 4 * 4;
+		int h = (usedHeight[a] + 3) / 4 * 4;
+		atlases[a]->pixels.allocate(w, h, OF_IMAGE_COLOR_ALPHA);
+		atlases[a]->pixels.set(0);
+		atlasVRAM += w * h * 4 / float(1024 * 1024);
+	}
+	ofLogNotice("ofxAnimationAssetManager") << "Packed " << small.size() << " static images into " << atlases.size() << " atlases ("
+		<< atlasVRAM << " Mb, " << unpackedMB << " Mb unpacked).";
+}
+
+
+bool ofxAnimationAssetManager::prefetch(const string & ID, int startFrame, float deadlineMs){
+
+	auto it = info.find(ID);
+	if(it == info.end()){
+		ofLogError("ofxAnimationAssetManager") << "prefetch() error! requested animation \"" << ID << "\" does not exist!";
+		return false;
+	}
+	if(it->second.type != ANIMATION || it->second.isPreloaded) return false;
+	prefetchQueue.push(PrefetchRequest{ofGetElapsedTimeMillis() + uint64_t(std::max(0.0f, deadlineMs)), ID, std::max(0, startFrame)});
+	return true;
+}
+
+
+void ofxAnimationAssetManager::updatePrefetch(){
+
+	//frames are in the OS cache; the animation may still be on screen paused somewhere else, so it
+	//only seeks there once the cue is due (and the app hasn't started it itself by then)
+	numPrefetchJobs -= finishedPrefetches.drain([this](PrefetchRequest && r){
+		if(r.deadlineMS >= lastUpdateTimeMS) cuedPrefetches.push_back(r);
+	});
+	for(size_t i = 0; i < cuedPrefetches.size();){
+		PrefetchRequest & r = cuedPrefetches[i];
+		if(r.deadlineMS > lastUpdateTimeMS){
+			i++;
+			continue;
+		}
+		ofxImageSequenceVideo & anim = animations[r.ID];
+		if(!anim.isPlaying() && !info[r.ID].isPreloaded){
+			anim.seekToFrame(r.startFrame);
+			info[r.ID].lastTouchMS = lastUpdateTimeMS;
+			activate(r.ID);
+		}
+		cuedPrefetches[i] = cuedPrefetches.back();
+		cuedPrefetches.pop_back();
+	}
+
+	//earliest deadlines first; leave some of the pool to whatever else is going on
+	int maxJobs = std::max(1, numThreadsToUse / 2);
+	while(numPrefetchJobs < maxJobs && prefetchQueue.size()){
+		PrefetchRequest r = prefetchQueue.top();
+		prefetchQueue.pop();
+		if(r.deadlineMS < lastUpdateTimeMS) continue; //expired, too late to help
+		if(info[r.ID].isPreloaded) continue; //got promoted in the meantime
+		auto listing = info[r.ID].listing;
+		if(!listing) continue; //not checked
+
+		//the files the animation is about to load; LOD folders hold the same file names
+		string folder = getFramesFolder(r.ID);
+		string ext = info[r.ID].useDxtCompression ? ".dxt" : "";
+		int numImages = listing->images.size();
+		int numFrames = std::max(1, assetLoadOptions[r.ID].bufferFrames);
+		vector<string> paths;
+		for(int i = r.startFrame; i < r.startFrame + numFrames && i < numImages; i++){
+			paths.push_back(folder + "/" + listing->images[playAssetsInReverse ? numImages - 1 - i : i] + ext);
+		}
+
+		CancelToken cancel = cancelToken;
+		numPrefetchJobs++;
+		workers.submit([this, r, paths, cancel](){
+			if(!isCancelled(cancel)) warmFrames(paths);
+			if(!isCancelled(cancel)) finishedPrefetches.push(r);
+		});
+	}
+}
+
+
+void ofxAnimationAssetManager::warmFrames(const vector<string> & paths){
+
+	//read the files the animation is about to load, so its own loader hits the OS cache
+	vector<char> buffer(1024 * 1024);
+	for(auto & path : paths){
+		std::ifstream file(path, std::ios::binary);
+		while(file.read(buffer.data(), buffer.size())){}
+	}
+}
+
+
+bool ofxAnimationAssetManager::setDrawSize(const string & ID, float w, float h){
+
+	auto it = info.find(ID);
+	if(it == info.end() || it->second.type != ANIMATION){
+		ofLogError("ofxAnimationAssetManager") << "setDrawSize() error! requested animation \"" << ID << "\" does not exist!";
+		return false;
+	}
+	auto & opt = assetLoadOptions[ID];
+	if(state != READY){ //picked up at PRELOADING_ASSETS
+		opt.drawWidth = w;
+		opt.drawHeight = h;
+		return true;
+	}
+
+	AssetInfo & i = it->second;
+	int level = pickLodLevel(ID, w, h);
+	ofxImageSequenceVideo & anim = animations[ID];
+	if(level != i.lodLevel && anim.isPlaying()){
+		ofLogWarning("ofxAnimationAssetManager") << "setDrawSize() can't switch \"" << ID << "\" to LOD " << level << " while it's playing!";
+		return false;
+	}
+	opt.drawWidth = w;
+	opt.drawHeight = h;
+	if(level == i.lodLevel) return true;
+
+	//reload from the other folder; the VRAM estimates change with it, and updateResidency() rebalances
+	int frame = anim.getCurrentFrameNumber();
+	i.lodLevel = level;
+	anim.loadImageSequence(getFramesFolder(ID), opt.framerate);
+	anim.setLoop(true);
+	anim.setKeepTexturesInGpuMem(i.isPreloaded);
+	anim.seekToFrame(frame);
+	i.estimatedSize = estimateAnimationVRAM(ID) / float(1024 * 1024);
+	i.estimatedFrameSize = anim.getNumFrames() > 0 ? i.estimatedSize / anim.getNumFrames() : 0;
+	i.lastTouchMS = lastUpdateTimeMS;
+	activate(ID);
+	ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << ID << "\" switched to LOD " << level << " (" << i.estimatedSize << " Mb to preload).";
+	return true;
+}
+
+
+int ofxAnimationAssetManager::getLodLevel(const string & ID){
+	auto it = info.find(ID);
+	return it != info.end() ? it->second.lodLevel : 0;
+}
+
+
+int ofxAnimationAssetManager::getUniqueFrame(const string & ID, int frame){
+	auto it = info.find(ID);
+	if(it != info.end() && frame >= 0 && frame < it->second.uniqueFrames.size()){
+		return it->second.uniqueFrames[frame];
+	}
+	return frame;
+}
+
+
+int ofxAnimationAssetManager::getNumUniqueFrames(const string & ID){
+	auto it = info.find(ID);
+	return it != info.end() ? it->second.numUniqueFrames : 0;
+}
+
+
+ofRectangle ofxAnimationAssetManager::getTrimRect(const string & ID){
+	auto it = info.find(ID);
+	if(it == info.end()) return ofRectangle();
+	if(it->second.isTrimmed) return it->second.trimRect;
+	return ofRectangle(0, 0, it->second.sourceWidth, it->second.sourceHeight);
+}
+
+
+void ofxAnimationAssetManager::drawAnimation(const string & ID, float x, float y, float w, float h){
+
+	ofTexture & tex = getTexture(ID);
+	if(!tex.isAllocated()) return;
+	auto it = info.find(ID);
+	if(it == info.end() || !it->second.isTrimmed || it->second.sourceWidth <= 0 || it->second.sourceHeight <= 0){
+		tex.draw(x, y, w, h); //the texture is the whole canvas (maybe at a smaller LOD)
+		return;
+	}
+	float sx = w / it->second.sourceWidth;
+	float sy = h / it->second.sourceHeight;
+	const ofRectangle & r = it->second.trimRect;
+	tex.draw(x + r.x * sx, y + r.y * sy, r.width * sx, r.height * sy);
+}
+
+
+int ofxAnimationAssetManager::pickLodLevel(const string & ID, float w, float h){
+
+	AssetInfo & i = info[ID];
+	auto & opt = assetLoadOptions[ID];
+	if(!opt.shouldUseDxtCompression || i.sourceWidth <= 0 || (w <= 0 && h <= 0)) return 0;
+	int maxLevel = ofClamp(opt.lodLevels, 0, MAX_LOD_LEVELS);
+	int level = 0;
+	while(level < maxLevel && (i.sourceWidth >> (level + 1)) >= w && (i.sourceHeight >> (level + 1)) >= h){
+		level++;
+	}
+	return level;
+}
+
+
+string ofxAnimationAssetManager::getLodFolder(const string & folder, int level){
+	return level > 0 ? folder + "/lod" + ofToString(level) : folder;
+}
+
+
+string ofxAnimationAssetManager::getFramesFolder(const string & ID){
+	AssetInfo & i = info[ID];
+	return getLodFolder(i.fullPath, i.lodLevel);
+}
+
+
+void ofxAnimationAssetManager::halfSize(const ofPixels & src, ofPixels & dst){
+
+	int sw = src.getWidth();
+	int sh = src.getHeight();
+	int ch = src.getNumChannels();
+	int w = std::max(1, sw / 2);
+	int h = std::max(1, sh / 2);
+	dst.allocate(w, h, ch);
+	const unsigned char * s = src.getData();
+	unsigned char * d = dst.getData();
+	for(int y = 0; y < h; y++){
+		const unsigned char * row0 = s + size_t(std::min(2 * y, sh - 1)) * sw * ch;
+		const unsigned char * row1 = s + size_t(std::min(2 * y + 1, sh - 1)) * sw * ch;
+		for(int x = 0; x < w; x++){
+			int x0 = std::min(2 * x, sw - 1) * ch;
+			int x1 = std::min(2 * x + 1, sw - 1) * ch;
+			for(int c = 0; c < ch; c++){
+				*d++ = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4;
+			}
+		}
+	}
+}
+
+
+ofxAnimationAssetManager::AssetHandle ofxAnimationAssetManager::getHandle(const string & ID){
+
+	auto h = handles.find(ID);
+	if(h != handles.end()) return h->second;
+
+	auto it = info.find(ID);
+	if(it == info.end()){
+		ofLogError("ofxAnimationAssetManager") << "getHandle() error! requested asset \"" << ID << "\" does not exist!";
+		return INVALID_ASSET_HANDLE;
+	}
+
+	AssetSlot slot;
+	slot.type = it->second.type;
+	slot.info = &it->second;
+	if(slot.type == STATIC_IMAGE){
+		slot.image = &images[ID];
+	}else{
+		slot.animation = &animations[ID];
+	}
+	AssetHandle handle = slots.size();
+	slots.push_back(slot);
+	handles[ID] = handle;
+	return handle;
+}
+
+
+ofxImageSequenceVideo & ofxAnimationAssetManager::getAnimation(AssetHandle handle){
+	if(handle >= 0 && handle < slots.size()){
+		AssetSlot & slot = slots[handle];
+		if(slot.animation){
+			slot.info->lastAccessMS = slot.info->lastTouchMS = lastUpdateTimeMS;
+			if(!slot.info->isActive){
+				slot.info->isActive = true;
+				activeAnimations.push_back(ActiveAnimation{slot.animation, slot.info});
+			}
+			return *slot.animation;
+		}
+		ofLogError("ofxAnimationAssetManager") << "getAnimation() error! handle " << handle << " is a static image!";
+		return nullAnim;
+	}
+	ofLogError("ofxAnimationAssetManager") << "getAnimation() error! invalid handle " << handle;
+	return nullAnim;
+}
+
+
+ofTexture & ofxAnimationAssetManager::getTexture(AssetHandle handle){
+	if(handle >= 0 && handle < slots.size()){
+		AssetSlot & slot = slots[handle];
+		slot.info->lastAccessMS = lastUpdateTimeMS;
+		if(slot.info->atlasIndex >= 0) return atlases[slot.info->atlasIndex]->texture;
+		return slot.image ? *slot.image : slot.animation->getTexture();
+	}
+	ofLogError("ofxAnimationAssetManager") << "getTexture() error! invalid handle " << handle;
+	return nullTexture;
+}
+
+
 void ofxAnimationAssetManager::update() {
 
 	if (lastUpdateTimeMS == 0) {
@@ -412,88 +1058,138 @@ void ofxAnimationAssetManager::update(float dt, uint64_t thisTimeMS){
 	switch (state) {
 		case UNINITED: break;
 
-		case CHECKING_ASSETS:
+		case CHECKING_ASSETS:{
+			//gather finished tasks
+			numCheckTasks -= finishedChecks.drain([this](CheckInfo && r){
+				AssetInfo & i = info[r.ID];
+				i.type = r.type;
+				i.fullPath = r.fullPath;
+				i.listing = r.listing;
+				if(r.isTrimmed){
+					info[r.ID].isTrimmed = true;
+					info[r.ID].trimRect = r.trimRect;
+				}
+				checked[r.ID] = std::move(r); //store check results
+			});
 			if (checked.size() == info.size() ){ //done
 				ofLogNotice("ofxAnimationAssetManager") << "done checking assets!";
 				setState(COMPRESSING_ASSETS);
-			}else{
-
-				//cleanup finshed tasks threads
-				for(int i = checkTasks.size() - 1; i >= 0; i--){
-					//see if thread is done, gather results and remove from vector
-					std::future_status status = checkTasks[i].wait_for(std::chrono::microseconds(0));
-					if(status == std::future_status::ready){ //thread is done
-						auto results = checkTasks[i].get();
-						checked[results.ID] = results; //store check results
-						checkTasks.erase(checkTasks.begin() + i);
-					}
-				}
-
-				//spawn new ones
-				while(checkTasks.size() < numThreadsToUse && pendingCheck.size()){ //spawn thread
-					string id = pendingCheck.front();
-					pendingCheck.erase(pendingCheck.begin());
-					checkProgress[id] = ProgressInfo();
-					checkTasks.push_back( std::async(std::launch::async, &ofxAnimationAssetManager::checkAsset, this, id, &checkProgress[id]) );
-				}
 			}
-			break;
+			}break;
 
-		case COMPRESSING_ASSETS:
-			if (pendingCompression.size() == 0 && compressTasks.size() == 0 && compressed.size() > 0){ //done
+		case COMPRESSING_ASSETS:{
+			//gather finished tasks
+			numCompressTasks -= finishedCompressions.drain([this](CompressInfo && r){
+				if(r.isTrimmed){
+					info[r.ID].isTrimmed = true;
+					info[r.ID].trimRect = r.trimRect;
+				}
+				compressed[r.ID] = r; //store results
+			});
+			if (numCompressTasks == 0){ //done
 				ofLogNotice("ofxAnimationAssetManager") << "done compressing assets!";
+				stopCompressionPipeline();
 				setState(PRELOADING_ASSETS);
-			}else{
-				//cleanup finshed tasks threads
-				for(int i = compressTasks.size() - 1; i >= 0; i--){
-					//see if thread is done, gather results and remove from vector
-					std::future_status status = compressTasks[i].wait_for(std::chrono::microseconds(0));
-					if(status == std::future_status::ready){ //thread is done
-						auto results = compressTasks[i].get();
-						compressed[results.ID] = results; //store results
-						compressTasks.erase(compressTasks.begin() + i);
-					}
-				}
-
-				//spawn new ones
-				while(compressTasks.size() < numThreadsToUse && pendingCompression.size()){ //spawn thread
-					string id = pendingCompression.front();
-					pendingCompression.erase(pendingCompression.begin());
-					compressProgress[id] = ProgressInfo();
-					compressTasks.push_back( std::async(std::launch::async, &ofxAnimationAssetManager::compressAsset, this, id, &compressProgress[id]) );
-				}
 			}
-			break;
+			}break;
 
 		case PRELOADING_ASSETS:{
-			int numThisFrame = 1;
-			if(pendingPreload.size())
-            {
-				while (numThisFrame > 0 && (pendingPreload.size()))
-                {
-					string ID = pendingPreload.front();
-					pendingPreload.erase(pendingPreload.begin());
-					if(info[ID].type == STATIC_IMAGE){
-
-                        ofLoadImage(images[ID], info[ID].fullPath);
-                        numThisFrame--;
-
-
+			//gather decoded static images
+			numPendingDecodes -= finishedDecodes.drain([this](DecodedImage && img){
+				pendingUploads.push_back(std::move(img));
+			});
+
+			if(pendingUploads.size() || pendingPreload.size()){
+				//do as much as fits in the time budget, estimating each item's cost from what we measured so far
+				float budget = getPreloadTimeBudget();
+				uint64_t startTime = ofGetElapsedTimeMicros();
+				bool first = true;
+				while(pendingUploads.size() || pendingPreload.size()){
+					bool isImage = pendingUploads.size() > 0;
+					string ID = isImage ? pendingUploads.front().ID : pendingPreload.front();
+					float estimate = isImage ? estimatedPreloadMsPerMB * info[ID].estimatedSize : estimatedPreloadMsPerAnimation;
+					float elapsed = (ofGetElapsedTimeMicros() - startTime) / 1000.0f;
+					if(!first && elapsed + estimate > budget) break;
+					first = false;
+
+					uint64_t itemStart = ofGetElapsedTimeMicros();
+					if(isImage){
+						DecodedImage img = std::move(pendingUploads.front());
+						pendingUploads.pop_front();
+						int a = info[ID].atlasIndex;
+						if(a >= 0){
+							Atlas & atlas = *atlases[a];
+							if(--atlas.pendingImages == 0){ //all its images are in, upload it in one go
+								atlas.texture.loadData(atlas.pixels);
+								atlas.pixels.clear();
+							}
+						}else if(img.pixels.isAllocated()){
+							images[ID].loadData(img.pixels); //GL upload only, decoding already happened
+						}
 					}else{
+						pendingPreload.pop_front();
 						animations[ID].setKeepTexturesInGpuMem(true);
+						info[ID].isPreloaded = true;
+					}
+					float took = (ofGetElapsedTimeMicros() - itemStart) / 1000.0f;
+					if(isImage){
+						uploadLatency.add(ofGetElapsedTimeMicros() - itemStart);
+						if(info[ID].estimatedSize > 0){
+							estimatedPreloadMsPerMB = ofLerp(estimatedPreloadMsPerMB, took / info[ID].estimatedSize, 0.25);
+						}
+					}else{
+						estimatedPreloadMsPerAnimation = ofLerp(estimatedPreloadMsPerAnimation, took, 0.25);
 					}
 				}
-			}else{
+			}else if(numPendingDecodes == 0){
+				for(auto & it : animations){ //everybody gets at least a few updates, idle ones drop out later
+					info[it.first].lastTouchMS = lastUpdateTimeMS;
+					activate(it.first);
+				}
 				setState(READY);
 			}
 			}break;
 
 		case READY:
         {
-			for(auto & it : animations){
-				it.second.update(dt);
+			//idle animations played or seeked through a reference kept from an earlier getAnimation() come back
+			for(size_t i = 0; i < idleAnimations.size();){
+				ActiveAnimation & a = idleAnimations[i];
+				if(!a.info->isActive && (a.animation->isPlaying() || a.animation->getCurrentFrameNumber() != a.info->idleFrame)){
+					a.info->isActive = true;
+					a.info->lastTouchMS = lastUpdateTimeMS;
+					activeAnimations.push_back(a);
+				}
+				if(a.info->isActive){ //back in activeAnimations
+					idleAnimations[i] = idleAnimations.back();
+					idleAnimations.pop_back();
+				}else{
+					i++;
+				}
+			}
 
+			//only animations that can change need updating. ofxImageSequenceVideo::update() is a single call that
+			//advances the playhead, feeds its own loader threads and uploads the texture, so there's no CPU only
+			//part to hand to the worker pool; the calls stay on the main thread
+			for(size_t i = 0; i < activeAnimations.size();){
+				ActiveAnimation & a = activeAnimations[i];
+				a.animation->update(dt);
+				bool stillActive = a.animation->isPlaying() ||
+								   lastUpdateTimeMS - a.info->lastTouchMS < activeGraceMS ||
+								   (a.animation->getKeepTexturesInGpuMem() && !a.animation->areAllTexturesPreloaded());
+				if(stillActive){
+					i++;
+				}else{
+					a.info->isActive = false;
+					a.info->idleFrame = a.animation->getCurrentFrameNumber();
+					idleAnimations.push_back(a);
+					activeAnimations[i] = activeAnimations.back();
+					activeAnimations.pop_back();
+				}
 			}
+			updatePrefetch();
+			updateAdaptiveBuffers();
+			updateResidency();
 			break;
         }
 		default:
@@ -502,59 +1198,861 @@ void ofxAnimationAssetManager::update(float dt, uint64_t thisTimeMS){
 }
 
 
-ofxAnimationAssetManager::CheckInfo ofxAnimationAssetManager::checkAsset(string ID, ofxAnimationAssetManager::ProgressInfo * progress){
+ofxAnimationAssetManager::CheckInfo ofxAnimationAssetManager::checkAsset(string ID, shared_ptr<ProgressInfo> progress, CancelToken cancel){
+
+	typedef ofxAnimationAssetManagerManifest Manifest;
 
 	ofxAnimationAssetManager::CheckInfo inf;
 	inf.ID = ID;
 	inf.done = true;
+	inf.type = info[ID].type;
+	inf.fullPath = info[ID].fullPath;
 	int c = 0;
-	if(info[ID].type == ANIMATION){
+	if(inf.type == ANIMATION || inf.type == UNKNOWN_ASSET_TYPE){ //a folder (unknown if it was empty last time)
 
-		if(assetLoadOptions[ID].shouldUseDxtCompression){
-			vector<string> allImages = ofxImageSequenceVideo::getImagesAtDirectory(info[ID].fullPath, false); //get list of all "png" (or other normal types) images
-			//count all images whith a missing .dxt representation
-			int needCompression = 0;
+		//listed once here, all the later stages use this listing
+		string folder = inf.fullPath;
+		bool dxt = assetLoadOptions[ID].shouldUseDxtCompression;
+		auto listing = scanFolder(folder, dxt ? ofClamp(assetLoadOptions[ID].lodLevels, 0, MAX_LOD_LEVELS) : 0);
+		if(listing->images.size() < 2){
+			inf.needsCompression = false;
+			if(listing->images.size() == 1){ //load the single image inside this folder
+				inf.type = STATIC_IMAGE;
+				inf.fullPath = folder + "/" + listing->images[0];
+				probeAsset(ID, inf.fullPath);
+				ofLogVerbose("ofxAnimationAssetManager") << "found STATIC_IMAGE with ID \"" << ID << "\"";
+			}else{
+				inf.type = UNKNOWN_ASSET_TYPE;
+				ofLogNotice("ofxAnimationAssetManager") << "can't load ANIMATION with ID \"" << ID << "\" because there are insufficient PNG or TGA files";
+			}
+			progress->pct = 1.0;
+			return inf;
+		}
+		inf.type = ANIMATION;
+		inf.listing = listing;
+
+		if(dxt){
+
+			const vector<string> & allImages = listing->images;
+			const unordered_set<string> & dxtFiles = listing->dxtFiles;
+			if(allImages.size()) probeAsset(ID, folder + "/" + allImages[0]); //all frames are the same size
+
+			//if the folder hasn't been touched since the manifest was written, the .dxt files don't need looking at
+			Manifest manifest;
+			bool hasManifest = manifest.load(folder);
+			bool folderUnchanged = false;
+			if(hasManifest){
+				uint64_t size;
+				int64_t manifestModified;
+				folderUnchanged = listing->folderModified != 0 &&
+								  Manifest::getFileStats(folder + "/" + Manifest::fileName, size, manifestModified) &&
+								  listing->folderModified <= manifestModified;
+			}
+			//.dxt files baked with a different trimming setting are no good
+			bool trim = assetLoadOptions[ID].trimTransparentBorders;
+			bool trimMismatch = trim != (hasManifest && manifest.getTrim().enabled);
+			bool statDxtFiles = !hasManifest || !folderUnchanged || cacheValidation != VALIDATE_CACHE_FAST;
+			bool hashFiles = hasManifest && cacheValidation == VALIDATE_CACHE_FULL;
+
+			//count all images whith a missing, stale or truncated .dxt representation
+			vector<string> & needCompression = inf.framesToCompress;
 			for(auto & img : allImages){
-				string fullPath = info[ID].fullPath + "/" + img + ".dxt";
-				ofFile f = ofFile(fullPath);
-				if(!f.exists() || f.getSize() == 0){
-					needCompression++;
+				bool ok = dxtFiles.find(img + ".dxt") != dxtFiles.end() && !trimMismatch;
+				const Manifest::Frame * mf = manifest.getFrame(img);
+				if(ok && hasManifest && mf == nullptr){
+					ok = false; //new frame since last compression
+				}
+				if(ok){
+					string fullPath = folder + "/" + img;
+					Manifest::Frame f;
+					//sources can be overwritten in place without the folder changing, so they always get a stat
+					ok = Manifest::getFileStats(fullPath, f.sourceSize, f.sourceModified);
+					if(ok && statDxtFiles){
+						int64_t dxtModified;
+						ok = Manifest::getFileStats(fullPath + ".dxt", f.dxtSize, dxtModified) && f.dxtSize > 0;
+					}
+					if(ok && mf){
+						ok = f.sourceSize == mf->sourceSize && f.sourceModified == mf->sourceModified &&
+							 (!statDxtFiles || f.dxtSize == mf->dxtSize);
+					}
+					if(ok && hashFiles){
+						bool hashOK;
+						ok = Manifest::hashFile(fullPath + ".dxt", hashOK, cancel.get()) == mf->dxtHash && hashOK;
+						getCounters(ID)->bytesRead += f.dxtSize;
+					}
+				}
+				if(!ok){
+					needCompression.push_back(img);
 				}
 				c++;
 				progress->pct = c / float(allImages.size());
-				if(needsToStop) break;
+				if(isCancelled(cancel)) break;
+			}
+
+			//LODs: as long as they are there they're fine, they get rebaked along with their full size frame
+			if(listing->lods.size() && !isCancelled(cancel)){
+				unordered_set<string> flagged(needCompression.begin(), needCompression.end());
+				for(auto & lod : listing->lods){
+					for(auto & img : allImages){
+						if(flagged.count(img)) continue;
+						if(!lod.images.count(img) || !lod.dxtFiles.count(img + ".dxt")){
+							flagged.insert(img);
+							needCompression.push_back(img);
+						}
+					}
+				}
+			}
+			inf.needsCompression = needCompression.size() > 0;
+
+			//cache is complete but the manifest doesn't vouch for it (made by an older version, or frames were
+			//removed / renamed since); write a fresh one so next launch takes the fast path again
+			if((!hasManifest || !folderUnchanged) && !inf.needsCompression && !isCancelled(cancel)){
+				Manifest fresh;
+				fresh.setTrim(manifest.getTrim());
+				for(auto & img : allImages){
+					const Manifest::Frame * mf = manifest.getFrame(img);
+					Manifest::Frame f;
+					if(mf){
+						f = *mf; //just validated by the stat pass
+					}else{
+						if(!Manifest::fillFrame(folder, img, f, cancel.get())) break;
+						getCounters(ID)->bytesRead += f.dxtSize;
+					}
+					fresh.setFrame(f);
+				}
+				if(fresh.getFrames().size() == allImages.size() && fresh.save(folder)){
+					manifest = fresh;
+				}
+			}
+
+			if(needCompression.size() > 0){
+				ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << ID << "\" has " << needCompression.size() << " frames with a missing or outdated .dxt file.";
+			}
+
+			if(!inf.needsCompression && trim){
+				const Manifest::Rect & r = manifest.getTrim().rect;
+				inf.isTrimmed = true;
+				inf.trimRect.set(r.x, r.y, r.width, r.height);
+			}
+
+			if(!inf.needsCompression && !isCancelled(cancel)){
+				vector<Manifest::Frame> frames;
+				for(auto & img : allImages){
+					const Manifest::Frame * mf = manifest.getFrame(img);
+					frames.push_back(mf ? *mf : Manifest::Frame());
+				}
+				indexDuplicateFrames(ID, frames);
+			}
+
+			//measure now if the .dxt files are all there, otherwise right after they're baked
+			if(!inf.needsCompression && assetLoadOptions[ID].adaptiveBuffering && !isCancelled(cancel)){
+				measureFrameLoad(ID, allImages, true, cacheValidation == VALIDATE_CACHE_FULL);
 			}
-			inf.needsCompression = needCompression > 0;
 		}else{
 			inf.needsCompression = false;
+			probeAsset(ID, folder + "/" + listing->images[0]);
+			if(assetLoadOptions[ID].adaptiveBuffering && !isCancelled(cancel)){
+				measureFrameLoad(ID, listing->images, false, false);
+			}
+			progress->pct = 1.0;
 		}
 	}else{
 		inf.needsCompression = false;
+		probeAsset(ID, info[ID].fullPath); //static image; sizes the VRAM plan & atlases without decoding it
 		progress->pct = 1.0;
 	}
 	return inf;
 }
 
 
-ofxAnimationAssetManager::CompressInfo ofxAnimationAssetManager::compressAsset(string ID, ofxAnimationAssetManager::ProgressInfo * progress){
+void ofxAnimationAssetManager::measureFrameLoad(const string & ID, const vector<string> & frames, bool dxt, bool justRead){
+
+	//a few frames spread over the sequence, read & decoded the way playback will. They're dropped from the OS cache
+	//first so they load cold, like frames the player hasn't buffered yet. Where the OS can't do that, files that
+	//were just written or hashed (justRead) would come straight from RAM and make the buffers far too small;
+	//those are left unmeasured, and playback sampling fills the estimate in
+	const int numSamples = 3;
+	if(frames.size() == 0) return;
+	float worstMs = 0;
+	float bytes = 0;
+	for(int s = 0; s < numSamples; s++){
+		string path = info[ID].fullPath + "/" + frames[(frames.size() - 1) * (s + 1) / (numSamples + 1)] + (dxt ? ".dxt" : "");
+		if(!ofxAnimationAssetManagerManifest::dropFromCache(path) && justRead) return;
+		float frameBytes = 0;
+		float ms = timeFrameLoad(path, dxt, frameBytes);
+		if(ms < 0) return;
+		worstMs = std::max(worstMs, ms);
+		bytes = std::max(bytes, frameBytes);
+	}
+	info[ID].measuredFrameLoadMs = worstMs;
+	info[ID].measuredFrameBytes = bytes;
+}
+
 
-	ofxAnimationAssetManager::CompressInfo inf;
-	inf.ID = ID;
-	vector<string> allImages = ofxImageSequenceVideo::getImagesAtDirectory(info[ID].fullPath, false);
-	int c = 0;
-	for(auto & imgName : allImages){
+float ofxAnimationAssetManager::timeFrameLoad(const string & path, bool dxt, float & bytes){
+
+	uint64_t start = ofGetElapsedTimeMicros();
+	if(dxt){
+		ofxDXT::Data data;
+		if(!ofxDXT::loadFromDisk(path, data)) return -1;
+		bytes = data.size();
+	}else{
 		ofPixels pix;
-		string fullPath = info[ID].fullPath + "/" + imgName;
-		ofLoadImage(pix, fullPath);
-		ofxDXT::Data compressedPix;
-		ofxDXT::compressRgbaPixels(pix, compressedPix);
-		ofxDXT::saveToDisk(compressedPix, fullPath + ".dxt");
-		c++;
-		progress->pct = c / float(allImages.size());
-		if(needsToStop) break;
+		if(!ofLoadImage(pix, path)) return -1;
+		bytes = pix.size();
 	}
-	inf.done = true;
-	return inf;
+	return (ofGetElapsedTimeMicros() - start) / 1000.0f;
+}
+
+
+void ofxAnimationAssetManager::updateAdaptiveBuffers(){
+
+	//fold in the frame loads timed during playback: a slow one counts right away, fast ones wear the estimate down slowly
+	bool replan = false;
+	frameLoadSamples.drain([this, &replan](FrameLoadSample && s){
+		for(auto & a : adaptiveAnimations){
+			if(a.ID != s.ID) continue;
+			a.isSampling = false;
+			if(s.ms < 0) break;
+			float fullSize = 1 << (2 * a.info->lodLevel); //measurements are at full size, each LOD has a quarter of the pixels
+			a.info->measuredFrameLoadMs = std::max(s.ms * fullSize, a.info->measuredFrameLoadMs * 0.9f);
+			if(a.info->measuredFrameBytes <= 0) a.info->measuredFrameBytes = s.bytes * fullSize;
+			replan = true;
+			break;
+		}
+	});
+	if(replan) planAdaptiveBuffers();
+
+	for(auto & a : adaptiveAnimations){
+		bool playing = a.animation->isPlaying();
+
+		//new plan: setting the animation up again drops its buffer, so only while it's stopped. Grow right
+		//away, but only shrink by a good margin so the slowly decaying estimate doesn't keep reloading it
+		bool grow = a.options->bufferFrames > a.bufferFrames || a.options->numThreads > a.numThreads;
+		bool shrink = a.options->bufferFrames < a.bufferFrames * 3 / 4;
+		if(!playing && !a.info->isPreloaded && (grow || shrink)){
+			int frame = a.animation->getCurrentFrameNumber();
+			a.bufferFrames = a.options->bufferFrames;
+			a.numThreads = a.options->numThreads;
+			a.animation->setup(a.numThreads, a.bufferFrames, a.info->useDxtCompression, playAssetsInReverse);
+			a.animation->loadImageSequence(getFramesFolder(a.ID), a.options->framerate);
+			a.animation->setLoop(true);
+			a.animation->setKeepTexturesInGpuMem(false);
+			a.animation->seekToFrame(frame);
+			a.info->lastTouchMS = lastUpdateTimeMS;
+			activate(a.ID);
+			ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << a.ID << "\" now buffers " << a.bufferFrames << " frames with " << a.numThreads << " threads.";
+		}
+
+		//time a frame a bit past the end of its buffer, which the player hasn't read yet
+		if(!playing || a.info->isPreloaded || a.isSampling || lastUpdateTimeMS - a.lastSampleMS < frameLoadSampleIntervalMS) continue;
+		auto listing = a.info->listing;
+		int numFrames = listing ? listing->images.size() : 0;
+		if(numFrames == 0) continue;
+		int frame = (a.animation->getCurrentFrameNumber() + a.bufferFrames + 1) % numFrames;
+		if(playAssetsInReverse) frame = numFrames - 1 - frame;
+		bool dxt = a.info->useDxtCompression;
+		string path = getFramesFolder(a.ID) + "/" + listing->images[frame] + (dxt ? ".dxt" : "");
+		a.lastSampleMS = lastUpdateTimeMS;
+		a.isSampling = true;
+		string ID = a.ID;
+		workers.submit([this, ID, path, dxt](){
+			float bytes = 0;
+			float ms = timeFrameLoad(path, dxt, bytes);
+			frameLoadSamples.push(FrameLoadSample{ID, ms, bytes});
+		});
+	}
+}
+
+
+void ofxAnimationAssetManager::setAdaptiveBuffering(float maxBufferRAM, int maxThreadsPerAnimation, int maxBufferFrames){
+	this->maxBufferRAM = maxBufferRAM;
+	maxAdaptiveThreads = std::max(1, maxThreadsPerAnimation);
+	maxAdaptiveBufferFrames = std::max(2, maxBufferFrames);
+}
+
+
+void ofxAnimationAssetManager::planAdaptiveBuffers(){
+
+	struct Item{
+		string ID;
+		int minBuffer;
+		float frameMB;
+	};
+	vector<Item> items;
+	float totalMB = 0;
+
+	for(auto & it : info){
+		auto & opt = assetLoadOptions[it.first];
+		if(it.second.type != ANIMATION || !opt.adaptiveBuffering) continue;
+		if(it.second.measuredFrameLoadMs <= 0){
+			if(state != READY){ //playback sampling might measure it later
+				ofLogWarning("ofxAnimationAssetManager") << "Animation \"" << it.first << "\" has no frame load measurement, keeping its bufferFrames & numThreads for now.";
+			}
+			continue;
+		}
+		float frameMs = 1000.0f / std::max(1, opt.framerate);
+		float lodScale = 1.0f / (1 << (2 * it.second.lodLevel)); //measured at full size, each LOD has a quarter of the pixels
+		float loadMs = it.second.measuredFrameLoadMs * lodScale * 1.5; //headroom for jitter & other animations loading at the same time
+		//enough threads to load frames as fast as they play, and enough buffer to keep them all busy
+		//plus cover the frames that play while one loads
+		opt.numThreads = ofClamp(ceil(loadMs / frameMs), 1, maxAdaptiveThreads);
+		int minBuffer = std::min(opt.numThreads + 1, maxAdaptiveBufferFrames);
+		opt.bufferFrames = ofClamp(ceil(loadMs / frameMs) + opt.numThreads + 1, minBuffer, maxAdaptiveBufferFrames);
+
+		float frameMB = it.second.measuredFrameBytes * lodScale / float(1024 * 1024);
+		items.push_back(Item{it.first, minBuffer, frameMB});
+		totalMB += opt.bufferFrames * frameMB;
+	}
+
+	//over the RAM cap, take frames away from whoever holds the most MB above their minimum
+	while(totalMB > maxBufferRAM){
+		Item * victim = nullptr;
+		float most = 0;
+		for(auto & item : items){
+			float spare = (assetLoadOptions[item.ID].bufferFrames - item.minBuffer) * item.frameMB;
+			if(spare > most){
+				most = spare;
+				victim = &item;
+			}
+		}
+		if(victim == nullptr){
+			ofLogWarning("ofxAnimationAssetManager") << "Adaptive buffers need at least " << totalMB << " Mb, over the " << maxBufferRAM << " Mb RAM limit!";
+			break;
+		}
+		assetLoadOptions[victim->ID].bufferFrames--;
+		totalMB -= victim->frameMB;
+	}
+
+	for(auto & item : items){
+		auto & opt = assetLoadOptions[item.ID];
+		ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << item.ID << "\" loads a frame in " << info[item.ID].measuredFrameLoadMs
+			<< "ms; buffering " << opt.bufferFrames << " frames with " << opt.numThreads << " threads.";
+	}
+}
+
+
+void ofxAnimationAssetManager::compressAsset(string ID, shared_ptr<ProgressInfo> progress, CancelToken cancel, const vector<string> & framesToCompress){
+
+	auto job = make_shared<CompressJob>();
+	job->ID = ID;
+	job->progress = progress;
+	job->startMicros = ofGetElapsedTimeMicros();
+	job->cancel = cancel;
+	job->lodLevels = ofClamp(assetLoadOptions[ID].lodLevels, 0, MAX_LOD_LEVELS);
+	string folder = info[ID].fullPath;
+	auto listing = info[ID].listing; //same listing as checkAsset() so both agree on the frames
+	if(!listing) listing = scanFolder(folder, 0);
+	const unordered_set<string> & dxtFiles = listing->dxtFiles;
+	job->frames = listing->images;
+	job->manifestFrames.resize(job->frames.size());
+	for(int l = 1; l <= job->lodLevels; l++){
+		ofDirectory::createDirectory(getLodFolder(folder, l), false, true);
+	}
+
+	//only bake what checkAsset() flagged (plus anything without a .dxt); the other frames keep
+	//their manifest entries so the new manifest still covers the whole sequence
+	unordered_set<string> flagged(framesToCompress.begin(), framesToCompress.end());
+	ofxAnimationAssetManagerManifest oldManifest;
+	oldManifest.load(folder);
+	job->trim.enabled = assetLoadOptions[ID].trimTransparentBorders;
+	job->trim.canvasWidth = info[ID].sourceWidth;
+	job->trim.canvasHeight = info[ID].sourceHeight;
+	job->oldTrimRect = job->trim.rect = oldManifest.getTrim().rect; //until the first pass says otherwise
+	job->scanning = job->trim.enabled;
+	job->queued.resize(job->frames.size(), false);
+
+	vector<shared_ptr<FrameTask>> tasks;
+	for(int i = 0; i < job->frames.size(); i++){
+		const string & name = job->frames[i];
+		bool compress = flagged.count(name) || dxtFiles.find(name + ".dxt") == dxtFiles.end();
+		if(!compress){
+			const ofxAnimationAssetManagerManifest::Frame * mf = oldManifest.getFrame(name);
+			if(job->trim.enabled && (mf == nullptr || !mf->hasAlphaBounds)){
+				compress = true; //we need its bounds
+			}else if(mf){
+				job->manifestFrames[i] = *mf;
+			}else if(!ofxAnimationAssetManagerManifest::fillFrame(folder, name, job->manifestFrames[i], cancel.get())){
+				compress = true; //no manifest entry (older cache) and we can't make one, bake it again
+			}else{
+				getCounters(ID)->bytesRead += job->manifestFrames[i].dxtSize;
+			}
+		}
+		if(compress){
+			auto task = make_shared<FrameTask>();
+			task->job = job;
+			task->frameIndex = i;
+			tasks.push_back(task);
+			job->queued[i] = true;
+		}
+	}
+	job->numToCompress = tasks.size();
+	if(isCancelled(cancel)) return;
+
+	ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << ID << "\": compressing " << tasks.size() << " of " << job->frames.size() << " frames.";
+	if(job->trim.enabled && job->trim.canvasWidth <= 0){
+		ofLogError("ofxAnimationAssetManager") << "Animation \"" << ID << "\" can't be trimmed, unknown canvas size!";
+		job->trim.enabled = job->scanning = false;
+	}
+	if(tasks.size() == 0){ //only the manifest needed refreshing
+		progress->pct = 1.0;
+		onAssetCompressed(job);
+		return;
+	}
+
+	{
+		//checked together with the insert, so a cancelLoading() in between can't leave this job's tasks
+		//behind in the queue for the next load's pipeline to pick up
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		if(!pipelineRunning || isCancelled(cancel)) return;
+		readQueue.insert(readQueue.end(), tasks.begin(), tasks.end());
+	}
+	pipelineChanged.notify_all();
+}
+
+
+void ofxAnimationAssetManager::startCompressionPipeline(){
+
+	if(pipelineRunning) return;
+	pipelineRunning = true;
+	dxtEncoder.setup(compressionBackend);
+	maxFramesInFlight = numThreadsToUse * 2 + 2; //enough to keep all workers fed while I/O runs ahead
+	readerThread = std::thread(&ofxAnimationAssetManager::readerLoop, this);
+	writerThread = std::thread(&ofxAnimationAssetManager::writerLoop, this);
+}
+
+
+void ofxAnimationAssetManager::stopCompressionPipeline(){
+
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		if(!pipelineRunning) return;
+		pipelineRunning = false;
+	}
+	pipelineChanged.notify_all();
+	if(readerThread.joinable()) readerThread.join();
+	if(writerThread.joinable()) writerThread.join();
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+	readQueue.clear();
+	writeQueue.clear();
+	framesInFlight = 0;
+}
+
+
+void ofxAnimationAssetManager::readerLoop(){
+
+	while(true){
+		shared_ptr<FrameTask> task;
+		{
+			std::unique_lock<std::mutex> lock(pipelineMutex);
+			pipelineChanged.wait(lock, [this]{
+				return !pipelineRunning || (readQueue.size() && framesInFlight < maxFramesInFlight);
+			});
+			if(!pipelineRunning) return;
+			task = readQueue.front();
+			readQueue.pop_front();
+			framesInFlight++;
+			peakFramesInFlight = std::max(peakFramesInFlight, framesInFlight);
+		}
+
+		if(isCancelled(task->job->cancel)){
+			finishFrame(task);
+			continue;
+		}
+
+		string fullPath = info[task->job->ID].fullPath + "/" + task->job->frames[task->frameIndex];
+		uint64_t start = ofGetElapsedTimeMicros();
+		task->fileData = ofBufferFromFile(fullPath, true);
+		readLatency.add(ofGetElapsedTimeMicros() - start);
+		getCounters(task->job->ID)->bytesRead += task->fileData.size();
+		if(task->fileData.size() == 0){
+			ofLogError("ofxAnimationAssetManager") << "can't read image at \"" << fullPath << "\" for compression!";
+			task->job->failed = true;
+			finishFrame(task);
+			continue;
+		}
+		workers.submit([this, task](){
+			encodeFrame(task);
+		});
+	}
+}
+
+
+void ofxAnimationAssetManager::encodeFrame(shared_ptr<FrameTask> task){
+
+	const std::atomic<bool> * cancel = task->job->cancel.get();
+	if(!isCancelled(task->job->cancel)){
+		ofPixels pix;
+		uint64_t start = ofGetElapsedTimeMicros();
+		bool loaded = ofLoadImage(pix, task->fileData);
+		if(loaded && task->job->scanning){
+			decodeLatency.add(ofGetElapsedTimeMicros() - start);
+			//first pass of a trimmed animation, only the bounds (nothing gets written)
+			int x0, y0, x1, y1;
+			auto & mf = task->job->manifestFrames[task->frameIndex];
+			mf.hasAlphaBounds = true;
+			mf.alphaBounds = ofxAnimationAssetManagerManifest::Rect();
+			if(ofxAnimationAssetManagerDxtEncoder::findAlphaBounds(pix, x0, y0, x1, y1)){
+				mf.alphaBounds = ofxAnimationAssetManagerManifest::Rect{x0, y0, x1 - x0, y1 - y0};
+			}
+		}else if(loaded){
+			uint64_t decoded = ofGetElapsedTimeMicros();
+			decodeLatency.add(decoded - start);
+			if(task->job->trim.enabled){
+				const auto & r = task->job->trim.rect;
+				pix.crop(r.x, r.y, r.width, r.height);
+			}
+			task->ok = dxtEncoder.compressRgbaPixels(pix, task->compressed, cancel); //false if cancelled midway
+			//each LOD is made from the one above it
+			int lodLevels = task->job->lodLevels;
+			task->lodCompressed.resize(lodLevels);
+			task->lodImages.resize(lodLevels);
+			string ext = ofToLower(ofFilePath::getFileExt(task->job->frames[task->frameIndex]));
+			ofImageFormat format = ext == "tga" ? OF_IMAGE_FORMAT_TGA : OF_IMAGE_FORMAT_PNG;
+			ofPixels lod;
+			for(int l = 0; l < lodLevels && task->ok; l++){
+				ofPixels smaller;
+				halfSize(l == 0 ? pix : lod, smaller);
+				lod = std::move(smaller);
+				task->ok = dxtEncoder.compressRgbaPixels(lod, task->lodCompressed[l], cancel) &&
+						   ofSaveImage(lod, task->lodImages[l], format);
+			}
+			encodeLatency.add(ofGetElapsedTimeMicros() - decoded);
+		}else{
+			ofLogError("ofxAnimationAssetManager") << "can't decode image \"" << task->job->frames[task->frameIndex] << "\" of \"" << task->job->ID << "\" for compression!";
+			task->job->failed = true;
+		}
+	}
+	task->fileData.clear(); //done with the source bytes
+
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		if(isCancelled(task->job->cancel)) return; //cancelLoading() already tore down the pipeline (or is about to)
+		writeQueue.push_back(task);
+	}
+	pipelineChanged.notify_all();
+}
+
+
+void ofxAnimationAssetManager::writerLoop(){
+
+	while(true){
+		shared_ptr<FrameTask> task;
+		{
+			std::unique_lock<std::mutex> lock(pipelineMutex);
+			pipelineChanged.wait(lock, [this]{ return !pipelineRunning || writeQueue.size(); });
+			if(!pipelineRunning) return;
+			task = writeQueue.front();
+			writeQueue.pop_front();
+		}
+
+		if(task->ok && !isCancelled(task->job->cancel)){
+			string folder = info[task->job->ID].fullPath;
+			string name = task->job->frames[task->frameIndex];
+			uint64_t start = ofGetElapsedTimeMicros();
+			//the old files might be hard links shared with other (held) frames, unlink instead of overwriting them
+			ofFile::removeFile(folder + "/" + name + ".dxt", false);
+			ofxDXT::saveToDisk(task->compressed, folder + "/" + name + ".dxt");
+			uint64_t lodBytes = 0;
+			for(int l = 0; l < task->lodCompressed.size(); l++){
+				string lodPath = getLodFolder(folder, l + 1) + "/" + name;
+				ofFile::removeFile(lodPath, false);
+				ofFile::removeFile(lodPath + ".dxt", false);
+				ofBufferToFile(lodPath, task->lodImages[l], true);
+				ofxDXT::saveToDisk(task->lodCompressed[l], lodPath + ".dxt");
+				lodBytes += task->lodImages[l].size() + task->lodCompressed[l].size();
+			}
+			writeLatency.add(ofGetElapsedTimeMicros() - start);
+			//the .dxt we just wrote is still in the OS cache, so hashing it back is cheap
+			auto & mf = task->job->manifestFrames[task->frameIndex];
+			if(ofxAnimationAssetManagerManifest::fillFrame(folder, name, mf, task->job->cancel.get())){
+				AssetCounters * c = getCounters(task->job->ID);
+				c->bytesWritten += mf.dxtSize + lodBytes;
+				c->framesCompressed++;
+			}else{
+				task->job->failed = true;
+			}
+		}
+		finishFrame(task);
+	}
+}
+
+
+void ofxAnimationAssetManager::finishFrame(shared_ptr<FrameTask> task){
+
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		framesInFlight--;
+	}
+	pipelineChanged.notify_all();
+
+	auto job = task->job;
+	int numDone = ++job->numDone;
+	float pct = numDone / float(job->numToCompress);
+	if(job->trim.enabled) pct = job->scanning ? 0.5f * pct : 0.5f + 0.5f * pct; //two passes
+	job->progress->pct = pct;
+	if(numDone == job->numToCompress){
+		//we're on the reader or writer thread; the epilogue (manifest, measuring, linking) is long and
+		//would hold up every other asset's frames, so it goes to the pool
+		bool scanned = job->scanning;
+		workers.submit([this, job, scanned](){
+			if(scanned){
+				onAssetScanned(job);
+			}else{
+				onAssetCompressed(job);
+			}
+		});
+	}
+}
+
+
+void ofxAnimationAssetManager::onAssetScanned(shared_ptr<CompressJob> job){
+
+	typedef ofxAnimationAssetManagerManifest Manifest;
+	job->scanning = false;
+	if(isCancelled(job->cancel)) return;
+	if(job->failed){
+		onAssetCompressed(job);
+		return;
+	}
+
+	//union of all the frames' bounds, grown to whole DXT blocks
+	int x0 = job->trim.canvasWidth, y0 = job->trim.canvasHeight, x1 = 0, y1 = 0;
+	for(auto & mf : job->manifestFrames){
+		const Manifest::Rect & b = mf.alphaBounds;
+		if(b.width <= 0 || b.height <= 0) continue;
+		x0 = std::min(x0, b.x);
+		y0 = std::min(y0, b.y);
+		x1 = std::max(x1, b.x + b.width);
+		y1 = std::max(y1, b.y + b.height);
+	}
+	if(x1 <= x0 || y1 <= y0){ //all transparent, keep a single block
+		x0 = y0 = 0;
+		x1 = y1 = 4;
+	}
+	x0 -= x0 % 4;
+	y0 -= y0 % 4;
+	x1 = std::min(job->trim.canvasWidth, (x1 + 3) / 4 * 4);
+	y1 = std::min(job->trim.canvasHeight, (y1 + 3) / 4 * 4);
+	job->trim.rect = Manifest::Rect{x0, y0, x1 - x0, y1 - y0};
+
+	//if the region moved, the frames baked earlier are cropped wrong and go through the second pass too
+	bool moved = !(job->trim.rect == job->oldTrimRect);
+	vector<shared_ptr<FrameTask>> tasks;
+	for(int i = 0; i < job->frames.size(); i++){
+		if(job->queued[i] || moved){
+			auto task = make_shared<FrameTask>();
+			task->job = job;
+			task->frameIndex = i;
+			tasks.push_back(task);
+		}
+	}
+	float area = job->trim.canvasWidth * float(job->trim.canvasHeight);
+	ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << job->ID << "\" trimmed to " << job->trim.rect.width << "x" << job->trim.rect.height
+		<< " at " << x0 << "," << y0 << " (" << ofToString(100 * job->trim.rect.width * job->trim.rect.height / area, 1) << "% of the canvas), baking " << tasks.size() << " frames.";
+
+	job->numDone = 0;
+	job->numToCompress = tasks.size();
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		if(!pipelineRunning || isCancelled(job->cancel)) return;
+		readQueue.insert(readQueue.end(), tasks.begin(), tasks.end());
+	}
+	pipelineChanged.notify_all();
+}
+
+
+void ofxAnimationAssetManager::onAssetCompressed(shared_ptr<CompressJob> job){
+
+	//only record a complete bake, anything else gets re-checked next launch
+	if(isCancelled(job->cancel)) return; //nobody is waiting for it anymore
+
+	if(!job->failed && assetLoadOptions[job->ID].adaptiveBuffering){
+		measureFrameLoad(job->ID, job->frames, true, true);
+	}
+
+	if(!job->failed){
+		linkDuplicateFrames(job);
+		indexDuplicateFrames(job->ID, job->manifestFrames);
+		ofxAnimationAssetManagerManifest manifest;
+		for(auto & f : job->manifestFrames){
+			manifest.setFrame(f);
+		}
+		manifest.setTrim(job->trim);
+		manifest.save(info[job->ID].fullPath);
+	}
+
+	getCounters(job->ID)->compressMicros = ofGetElapsedTimeMicros() - job->startMicros;
+
+	CompressInfo results;
+	results.ID = job->ID;
+	results.done = true;
+	if(!job->failed && job->trim.enabled){
+		const auto & r = job->trim.rect;
+		results.isTrimmed = true;
+		results.trimRect.set(r.x, r.y, r.width, r.height);
+	}
+	finishedCompressions.push(std::move(results));
+}
+
+
+void ofxAnimationAssetManager::linkDuplicateFrames(shared_ptr<CompressJob> job){
+
+	typedef ofxAnimationAssetManagerManifest Manifest;
+	string folder = info[job->ID].fullPath;
+	map<pair<uint64_t, uint64_t>, int> firstWithContent; //{dxt hash, dxt size} -> frame
+	int numLinked = 0;
+
+	for(int i = 0; i < job->frames.size(); i++){
+		if(isCancelled(job->cancel)) return;
+		Manifest::Frame & mf = job->manifestFrames[i];
+		auto key = std::make_pair(mf.dxtHash, mf.dxtSize);
+		auto it = firstWithContent.find(key);
+		if(it == firstWithContent.end()){
+			firstWithContent[key] = i;
+			continue;
+		}
+		const string & firstName = job->frames[it->second];
+		string first = folder + "/" + firstName;
+		string dup = folder + "/" + mf.name;
+		//linked by an earlier bake already, no need to read them both again
+		bool linked = Manifest::isSameFile(first + ".dxt", dup + ".dxt");
+		if(!linked){
+			if(!Manifest::haveSameContents(first + ".dxt", dup + ".dxt")) continue; //hash collision
+			if(!Manifest::linkFile(first + ".dxt", dup + ".dxt")) continue; //ie FAT32, keep the copies
+			numLinked++;
+		}
+
+		//DXT is lossy, different sources can encode to the same blocks and still have different LODs; compare them too
+		for(int l = 1; l <= job->lodLevels; l++){
+			string lodFolder = getLodFolder(folder, l);
+			for(const string & ext : {string(""), string(".dxt")}){
+				string from = lodFolder + "/" + firstName + ext;
+				string to = lodFolder + "/" + mf.name + ext;
+				if(!Manifest::isSameFile(from, to) && Manifest::haveSameContents(from, to)){
+					Manifest::linkFile(from, to);
+				}
+			}
+		}
+	}
+	if(numLinked > 0){
+		ofLogVerbose("ofxAnimationAssetManager") << "Animation \"" << job->ID << "\": " << numLinked << " held frames linked to identical ones.";
+	}
+}
+
+
+void ofxAnimationAssetManager::indexDuplicateFrames(const string & ID, const vector<ofxAnimationAssetManagerManifest::Frame> & frames){
+
+	//frames without a manifest entry (dxtSize 0) are never merged
+	map<pair<uint64_t, uint64_t>, int> firstWithContent;
+	vector<int> unique(frames.size());
+	int numUnique = 0;
+	for(int i = 0; i < frames.size(); i++){
+		unique[i] = i;
+		if(frames[i].dxtSize > 0){
+			auto key = std::make_pair(frames[i].dxtHash, frames[i].dxtSize);
+			auto it = firstWithContent.find(key);
+			if(it != firstWithContent.end()){
+				unique[i] = it->second;
+				continue;
+			}
+			firstWithContent[key] = i;
+		}
+		numUnique++;
+	}
+	info[ID].uniqueFrames = std::move(unique);
+	info[ID].numUniqueFrames = numUnique;
+}
+
+
+ofxAnimationAssetManager::AssetCounters * ofxAnimationAssetManager::getCounters(const string & ID){
+	auto it = counters.find(ID);
+	return it != counters.end() ? it->second.get() : nullptr;
+}
+
+
+void ofxAnimationAssetManager::resetStats(){
+	stats = Stats();
+	readLatency.reset();
+	decodeLatency.reset();
+	encodeLatency.reset();
+	writeLatency.reset();
+	uploadLatency.reset();
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		peakFramesInFlight = 0;
+	}
+	loadStartMicros = ofGetElapsedTimeMicros();
+}
+
+
+void ofxAnimationAssetManager::fillStage(Stats::Stage & stage, uint64_t now){
+	stage.wallMs = (now - stageStartMicros) / 1000.0f;
+	uint64_t busy = workers.getBusyMicros() - stageStartBusyMicros;
+	uint64_t available = (now - stageStartMicros) * std::max(1, workers.getNumThreads());
+	stage.workerUtilization = available > 0 ? busy / double(available) : 0;
+	stage.peakQueuedJobs = workers.getPeakQueuedJobs();
+}
+
+
+void ofxAnimationAssetManager::onStageChange(State from, State to){
+
+	uint64_t now = ofGetElapsedTimeMicros();
+	switch(from){
+		case CHECKING_ASSETS: fillStage(stats.checking, now); break;
+		case COMPRESSING_ASSETS: fillStage(stats.compressing, now); break;
+		case PRELOADING_ASSETS: fillStage(stats.preloading, now); break;
+		default: break;
+	}
+	if(to == CHECKING_ASSETS) resetStats();
+	if(to == READY) stats.totalLoadMs = (now - loadStartMicros) / 1000.0f;
+
+	stageStartMicros = now;
+	stageStartBusyMicros = workers.getBusyMicros();
+	workers.resetPeakQueuedJobs();
+}
+
+
+ofxAnimationAssetManager::Stats ofxAnimationAssetManager::getStats(){
+
+	Stats s = stats;
+	uint64_t now = ofGetElapsedTimeMicros();
+	switch(state){ //the running stage
+		case CHECKING_ASSETS: fillStage(s.checking, now); break;
+		case COMPRESSING_ASSETS: fillStage(s.compressing, now); break;
+		case PRELOADING_ASSETS: fillStage(s.preloading, now); break;
+		default: break;
+	}
+	if(state != READY && state != UNINITED){
+		s.totalLoadMs = (now - loadStartMicros) / 1000.0f;
+	}
+
+	for(auto & it : counters){
+		Stats::Asset & a = s.assets[it.first];
+		a.bytesRead = it.second->bytesRead;
+		a.bytesWritten = it.second->bytesWritten;
+		a.framesCompressed = it.second->framesCompressed;
+		a.checkMs = it.second->checkMicros / 1000.0f;
+		a.compressMs = it.second->compressMicros / 1000.0f;
+	}
+
+	s.readLatency = readLatency.get();
+	s.decodeLatency = decodeLatency.get();
+	s.encodeLatency = encodeLatency.get();
+	s.writeLatency = writeLatency.get();
+	s.uploadLatency = uploadLatency.get();
+
+	s.numThreads = workers.getNumThreads();
+	s.queuedJobs = workers.getNumQueuedJobs();
+	s.activeJobs = workers.getNumActiveJobs();
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		s.pipelineReadQueue = readQueue.size();
+		s.pipelineWriteQueue = writeQueue.size();
+		s.pipelineFramesInFlight = framesInFlight;
+		s.pipelinePeakFramesInFlight = peakFramesInFlight;
+	}
+	return s;
 }
 
 
@@ -582,6 +2080,141 @@ ofxAnimationAssetManager::State ofxAnimationAssetManager::toEnum_State(const str
 }
 
 
+bool ofxAnimationAssetManager::probeImage(const string & path, int & width, int & height, int & numChannels){
+
+	std::ifstream file(path, std::ios::binary);
+	if(!file.is_open()) return false;
+	unsigned char h[33];
+	file.read((char*)h, sizeof(h));
+	size_t n = file.gcount();
+	auto be32 = [](const unsigned char * p){ return int((uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]); };
+
+	//PNG: signature, then the IHDR chunk always comes first
+	static const unsigned char pngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	if(n == sizeof(h) && memcmp(h, pngSignature, 8) == 0 && memcmp(h + 12, "IHDR", 4) == 0){
+		width = be32(h + 16);
+		height = be32(h + 20);
+		int colorType = h[25];
+		switch(colorType){
+			case 0: numChannels = 1; break; //gray
+			case 2: numChannels = 3; break; //rgb
+			case 3: numChannels = 3; break; //palette
+			case 4: numChannels = 2; break; //gray + alpha
+			case 6: numChannels = 4; break; //rgba
+			default: return false;
+		}
+		//a tRNS chunk (before the image data) means it decodes with alpha
+		if(colorType == 0 || colorType == 2 || colorType == 3){
+			unsigned char chunk[8];
+			while(file.read((char*)chunk, 8)){
+				if(memcmp(chunk + 4, "IDAT", 4) == 0 || memcmp(chunk + 4, "IEND", 4) == 0) break;
+				if(memcmp(chunk + 4, "tRNS", 4) == 0){
+					numChannels = colorType == 0 ? 2 : 4;
+					break;
+				}
+				file.seekg(uint32_t(be32(chunk)) + 4, std::ios::cur); //data + crc
+			}
+		}
+		return width > 0 && height > 0;
+	}
+
+	//TGA: no signature, just an 18 byte header that has to make sense
+	if(n >= 18 && ofToLower(ofFilePath::getFileExt(path)) == "tga"){
+		int imageType = h[2];
+		int colorMapDepth = h[7];
+		width = h[12] | (h[13] << 8);
+		height = h[14] | (h[15] << 8);
+		int depth = h[16];
+		int alphaBits = h[17] & 0x0F;
+		switch(imageType){
+			case 1: case 9: numChannels = colorMapDepth == 32 ? 4 : 3; break; //color mapped
+			case 2: case 10: numChannels = depth == 32 || (depth == 16 && alphaBits) ? 4 : 3; break; //true color
+			case 3: case 11: numChannels = depth == 16 ? 2 : 1; break; //gray
+			default: return false;
+		}
+		return width > 0 && height > 0;
+	}
+	return false;
+}
+
+
+void ofxAnimationAssetManager::probeAsset(const string & ID, const string & imagePath){
+	int w, h, c;
+	AssetInfo & i = info[ID];
+	if(probeImage(imagePath, w, h, c)){
+		i.sourceWidth = w;
+		i.sourceHeight = h;
+		i.numChannels = c;
+	}else{ //some other format, let the decoder figure it out (still off the main thread)
+		bool imgOK;
+		ofxImageSequenceVideo::getImageInfo(imagePath, i.sourceWidth, i.sourceHeight, i.numChannels, imgOK);
+		if(!imgOK) i.sourceWidth = i.sourceHeight = i.numChannels = 0;
+	}
+}
+
+
+uint64_t ofxAnimationAssetManager::estimateAnimationVRAM(const string & ID){
+
+	AssetInfo & i = info[ID];
+	ofxImageSequenceVideo & anim = animations[ID];
+	if(i.sourceWidth <= 0 || i.sourceHeight <= 0){ //couldn't probe it, ask ofxImageSequenceVideo
+		return anim.getEstimatdVramUse();
+	}
+	int w = i.isTrimmed ? i.trimRect.width : i.sourceWidth;
+	int h = i.isTrimmed ? i.trimRect.height : i.sourceHeight;
+	w = std::max(1, w >> i.lodLevel);
+	h = std::max(1, h >> i.lodLevel);
+	uint64_t frameBytes;
+	if(i.useDxtCompression){
+		frameBytes = uint64_t((w + 3) / 4) * ((h + 3) / 4) * 16; //DXT5, 16 bytes per 4x4 block
+	}else{
+		frameBytes = uint64_t(w) * h * std::max(1, i.numChannels);
+	}
+	return frameBytes * anim.getNumFrames();
+}
+
+
+shared_ptr<const ofxAnimationAssetManager::FolderListing> ofxAnimationAssetManager::scanFolder(const string & folder, int lodLevels){
+	auto listing = make_shared<FolderListing>();
+	uint64_t size;
+	if(!ofxAnimationAssetManagerManifest::getFileStats(folder, size, listing->folderModified)){ //before listing, so a change during it shows
+		listing->folderModified = 0;
+	}
+	listAnimationFolder(folder, listing->images, listing->dxtFiles);
+	listing->lods.resize(lodLevels);
+	for(int l = 1; l <= lodLevels; l++){
+		string lodFolder = getLodFolder(folder, l);
+		if(!ofDirectory::doesDirectoryExist(lodFolder, false)) continue;
+		vector<string> lodImages;
+		listAnimationFolder(lodFolder, lodImages, listing->lods[l - 1].dxtFiles);
+		listing->lods[l - 1].images.insert(lodImages.begin(), lodImages.end());
+	}
+	return listing;
+}
+
+
+void ofxAnimationAssetManager::listAnimationFolder(const string & folder, vector<string> & images, unordered_set<string> & dxtFiles){
+
+	//frame numbers are the player's, so the frames come from (and in the order of) its own listing
+	images = ofxImageSequenceVideo::getImagesAtDirectory(folder, false);
+
+	DIR * dir = opendir(folder.c_str());
+	if(dir == nullptr){
+		ofLogError("ofxAnimationAssetManager") << "can't list folder \"" << folder << "\"";
+		return;
+	}
+	struct dirent * ent;
+	while((ent = readdir(dir)) != nullptr){
+		string name = ent->d_name;
+		if(name.size() == 0 || name[0] == '.') continue;
+		if(ofToLower(ofFilePath::getFileExt(name)) == "dxt"){
+			dxtFiles.insert(name);
+		}
+	}
+	closedir(dir);
+}
+
+
 std::string ofxAnimationAssetManager::bytesToHumanReadable(long long bytes, int decimalPrecision){
 	std::string ret;
 	if (bytes < 1024 ){ //if in bytes range
@@ -653,12 +2286,12 @@ void ofxAnimationAssetManager::drawDebug(int x, int y, int w, int h){
 
 			}else{ // ANIMATION
 
-				ofTexture & tex = images[it.first];
+				AtlasRegion region = getAtlasRegion(it.first);
 
-				if(tex.isAllocated()){
-					ofRectangle r = ofRectangle(0,0, tex.getWidth(), tex.getHeight());
+				if(region.texture && region.texture->isAllocated()){
+					ofRectangle r = ofRectangle(0,0, region.rect.width, region.rect.height);
 					r.scaleTo(ofRectangle(0,0,gridW - pad, gridH - pad));
-					tex.draw(xx, yy, r.width, r.height);
+					drawImage(it.first, xx, yy, r.width, r.height);
 				}
 
 				ofSetColor(0,255,255);
@@ -9,8 +9,14 @@
 
 #pragma once
 #include "ofMain.h"
+#include <queue>
 #include "ofxDXT.h"
 #include "ofxImageSequenceVideo.h"
+#include "ofxAnimationAssetManagerWorkerPool.h"
+#include "ofxAnimationAssetManagerManifest.h"
+#include "ofxAnimationAssetManagerDxtEncoder.h"
+#include "ofxAnimationAssetManagerStats.h"
+#include "ofxAnimationAssetManagerCompletionQueue.h"
 
 class ofxAnimationAssetManager{
 
@@ -36,6 +42,13 @@ public:
 		UNKNOWN_ASSET_TYPE
 	};
 
+	enum CacheValidation{ //how hard to look at the existing .dxt files during CHECKING_ASSETS
+		VALIDATE_CACHE_FAST,	//compare source image sizes & dates against the manifest (one stat per frame); the .dxt files
+								//are only looked at if something was added / removed from the folder since it was written
+		VALIDATE_CACHE_SOURCES,	//always compare source image sizes & dates and .dxt sizes against the manifest
+		VALIDATE_CACHE_FULL		//same as above, plus re-hash the contents of every .dxt file
+	};
+
 	struct AssetLoadOptions{
 		bool shouldUseDxtCompression = true; 			//set to false if you want to force non-compression of this asset
 		int framerate = 30; 							//does not apply to static images
@@ -43,6 +56,27 @@ public:
 		int numThreads = 4;							//how many threads are allowed to work on the pre-loading of future frames
 		UserOption shouldPreloadAsset = DONT_CARE; 	//let ofxAnimationAssetManager decide given how much memory is available
 													//use YES or NO to force otherwise - Note that StaticImages are always preloaded
+		float playFrequency = 1.0;					//how often this animation plays, relative to others (used by the VRAM planner)
+		float streamCost = 1.0;						//how costly it is to stream it from disk instead, relative to others (ie raise if it stutters)
+		bool adaptiveBuffering = false;				//ignore bufferFrames & numThreads, size them from the measured frame load time instead (see setAdaptiveBuffering())
+		int lodLevels = 0;							//also bake 1/2 (1) and 1/2 + 1/4 (2) size versions of the frames, in "lod1" / "lod2" subfolders (only with DXT compression)
+		float drawWidth = 0;						//size it will be drawn at, picks the smallest baked LOD that still covers it (see setDrawSize())
+		float drawHeight = 0;						//0 = don't care
+		bool trimTransparentBorders = false;		//only bake the part of the canvas where some frame has visible pixels (only with DXT compression), see drawAnimation()
+	};
+
+	static const int MAX_LOD_LEVELS = 2;
+
+	typedef int AssetHandle; //cheap, stable index for an asset; see getHandle()
+	static const AssetHandle INVALID_ASSET_HANDLE = -1;
+
+	struct PreloadPlan{ //what the VRAM planner decided at PRELOADING_ASSETS
+		float budget = 0;			//MB available to preload whole animations (after static images & one frame of each animation)
+		float used = 0;				//MB taken by the preloaded animations
+		float leftover = 0;			//MB of budget nobody could use
+		float value = 0;			//sum of playFrequency * streamCost * unique (streamed) size of the preloaded animations
+		vector<string> preloaded;	//forced (shouldPreloadAsset == YES) and chosen animations
+		vector<string> streamed;
 	};
 
 	ofxAnimationAssetManager();
@@ -54,14 +88,50 @@ public:
 	// (2) Set the parameters used in loading separately from the individual assets
 	// Call this once:
 	void setup(float maxUsedVRAM, int numThreads = std::thread::hardware_concurrency(), bool playAssetsInReverse = false);
-	// Call any of these once for each asset added:
+	// Call any of these once for each asset added. Folders aren't listed until startLoading(): one holding a single
+	// image turns into a STATIC_IMAGE then, an empty one into an UNKNOWN_ASSET_TYPE that doesn't load
 	bool addAsset(string ID, string& path, AssetLoadOptions& options);
 	bool addAsset(string ID, string& path);
 	bool addAsset(string& path, AssetLoadOptions& options);
 	bool addAsset(string& path);
 
+	//defaults to VALIDATE_CACHE_FAST, which catches source images overwritten in place. Use VALIDATE_CACHE_SOURCES
+	//if something other than this addon might rewrite the .dxt files
+	void setCacheValidation(CacheValidation v){cacheValidation = v;}
+
+	//which DXT encoder to bake assets with. Defaults to BACKEND_OFXDXT; BACKEND_SIMD produces the same .dxt
+	//files faster (verified at startup, falls back to BACKEND_OFXDXT otherwise)
+	void setCompressionBackend(ofxAnimationAssetManagerDxtEncoder::Backend b){compressionBackend = b;}
+
+	//once READY, keep revisiting which animations are preloaded in VRAM: animations accessed
+	//through getTexture() / getAnimation() in the last hotAfterSec get promoted to preloaded,
+	//evicting the least recently used ones (not accessed for at least coldAfterSec) to make room.
+	//Animations with shouldPreloadAsset YES / NO are never touched. Enabled by default.
+	void setResidencyManagement(bool enabled, float checkIntervalSec = 1.0, float hotAfterSec = 2.0, float coldAfterSec = 30.0);
+
+	//limits for animations with adaptiveBuffering. Their frame load time is measured on a few frames while
+	//checking (cold, out of the OS cache), and the buffer / thread count picked to keep up with their framerate
+	//with some headroom. While they play, a frame ahead of the playhead gets timed every couple of seconds;
+	//buffers are re-planned from that and applied whenever the animation isn't playing.
+	//If all buffers together would take more than maxBufferRAM (MB), the biggest ones get trimmed.
+	void setAdaptiveBuffering(float maxBufferRAM, int maxThreadsPerAnimation = 4, int maxBufferFrames = 60);
+
+	//pack static images no bigger than maxImageSize x maxImageSize into shared atlas textures (up to atlasSize
+	//square) at PRELOADING_ASSETS: less VRAM fragmentation and a single texture bind to draw them all. getTexture()
+	//returns the whole atlas for those, draw them through getAtlasRegion() or drawImage(). Off by default.
+	void setAtlasing(bool enabled, int maxImageSize = 256, int atlasSize = 2048);
+
+	//how long each update() call can spend preloading assets in PRELOADING_ASSETS (ms).
+	//0 (default) means half a frame at the target framerate. At least one asset is preloaded per call.
+	void setPreloadTimeBudget(float ms){preloadTimeBudgetMS = ms;}
+
 	//starts checking provided assets folder, compressing assets if necessary
 	void startLoading();
+	//abort a load midway (back to UNINITED); returns as soon as the background work winds down,
+	//which is within a frame's worth of work. Assets already set up / uploaded are left as they are.
+	void cancelLoading();
+	//cancelLoading() + startLoading(), ie to pick up changed AssetLoadOptions or assets
+	void restartLoading();
 
 	// Update the animation's progress with either of these methods.
 	// (These can be used interchangeably throughout an application).
@@ -69,10 +139,16 @@ public:
 	void update(float dt);
 
 	State getState(){return state;}
+	const PreloadPlan & getPreloadPlan(){return preloadPlan;}
 
 	void drawDebug(int x, int y, int w, int h); //draw all assets to screen and their state
 	string getStatus(); //get obj status (as a string) for debug / setup progress
 
+	//loading instrumentation (stage timings, per asset I/O, per frame latencies, worker load).
+	//Reset at startLoading(). Use getStats().toJson() to dump it.
+	typedef ofxAnimationAssetManagerStats Stats;
+	Stats getStats();
+
 	//get all available asset IDs
 	vector<string> getStaticImageIDs();
 	vector<string> getAnimationIDs();
@@ -82,18 +158,75 @@ public:
 	ofxImageSequenceVideo & getAnimation(const string & ID); //direct access to animation objects
 	ofTexture & getTexture(const string & ID); //get the ofTexture of StaticImage or Animation indistinctively
 
+	struct AtlasRegion{
+		ofTexture * texture = nullptr;	//the atlas, or the image's own texture if it wasn't packed
+		ofRectangle rect;				//where the image is in that texture, in pixels
+		ofRectangle uv;					//same, normalized (0..1)
+	};
+	AtlasRegion getAtlasRegion(const string & ID); //texture is nullptr for unknown IDs & animations
+	void drawImage(const string & ID, float x, float y, float w, float h); //static images, packed or not
+
+	//same as above, without any string hashing. Resolve the handle once (any time after the asset
+	//was added) and use it in your per-frame code. Handles stay valid for the lifetime of the manager.
+	AssetHandle getHandle(const string & ID); //INVALID_ASSET_HANDLE if no such asset
+	ofxImageSequenceVideo & getAnimation(AssetHandle handle);
+	ofTexture & getTexture(AssetHandle handle);
+
+	//get a streamed animation ready to play from startFrame within deadlineMs (from now), ie ahead of a cue:
+	//its upcoming frames get read into the OS cache on the worker pool, and once the deadline is due it seeks
+	//there (if it isn't playing by then), loading them from RAM. Until then it stays wherever it was.
+	//Requests are served earliest deadline first. Can be called before READY.
+	//Returns false for unknown IDs, static images and preloaded animations (nothing to do).
+	bool prefetch(const string & ID, int startFrame, float deadlineMs);
+
+	//draw an animation at (up to) this size: it switches to the smallest LOD baked for it (see AssetLoadOptions::lodLevels)
+	//that still covers w x h, so it streams, decodes and takes VRAM at that size. Its texture is then the size of the LOD,
+	//draw it scaled. Before READY this goes into the VRAM plan; once READY it returns false if the animation is playing.
+	bool setDrawSize(const string & ID, float w, float h);
+	int getLodLevel(const string & ID); //0 full size, 1 half, 2 quarter
+
+	//held frames (identical to another frame of the same animation) are baked once: their .dxt files are hard
+	//links of each other. Known for DXT compressed animations, once checked.
+	int getUniqueFrame(const string & ID, int frame); //first frame (in folder order) with the same content as this one
+	int getNumUniqueFrames(const string & ID); //0 if not known
+
+	//animations baked with trimTransparentBorders only hold a region of their canvas (and so does their texture).
+	//getTrimRect() tells where it sits, in canvas (source image) pixels; the whole canvas if not trimmed
+	ofRectangle getTrimRect(const string & ID);
+	//draws the current frame of an animation as if it was its whole canvas, placing trimmed / LOD textures where they belong
+	void drawAnimation(const string & ID, float x, float y, float w, float h);
+
 
 protected:
 
+	struct FolderListing{ //one scan of an animation folder, shared by all the loading stages (never modified once made)
+		vector<string> images; //source images, in the player's frame order
+		unordered_set<string> dxtFiles; //names of all the .dxt files
+		int64_t folderModified = 0; //folder date right before it was listed
+		struct Lod{
+			unordered_set<string> images;
+			unordered_set<string> dxtFiles;
+		};
+		vector<Lod> lods; //lods[l - 1] is the "lod<l>" subfolder, empty if it's not there; as many as the asset bakes
+	};
+
 	struct CheckInfo{
 		string ID;
 		bool done = false;
 		bool needsCompression = false;
+		vector<string> framesToCompress; //the ones with a missing or outdated .dxt file
+		AssetType type = UNKNOWN_ASSET_TYPE; //what the folder turned out to hold, copied into AssetInfo on the main thread
+		string fullPath; //same, the image of a single image folder
+		shared_ptr<const FolderListing> listing; //same, animations
+		bool isTrimmed = false; //from the manifest, copied into AssetInfo on the main thread
+		ofRectangle trimRect;
 	};
 
 	struct CompressInfo{
 		string ID;
 		bool done = false;
+		bool isTrimmed = false; //as baked, copied into AssetInfo on the main thread
+		ofRectangle trimRect;
 	};
 
 	struct AssetInfo{
@@ -101,7 +234,25 @@ protected:
 		string fullPath;
 		bool isPreloaded = false;
 		bool useDxtCompression = true;
+		shared_ptr<const FolderListing> listing; //animations, scanned by their check job at CHECKING_ASSETS
 		float estimatedSize = 0; //in Mbytes
+		float estimatedFrameSize = 0; //in Mbytes, size of a single frame (what a streamed animation takes)
+		uint64_t lastAccessMS = 0; //last time it was accessed through getTexture() / getAnimation()
+		uint64_t lastTouchMS = 0; //last time it was handed out through getAnimation() (and so could have been played / seeked)
+		bool isActive = false; //in activeAnimations
+		int idleFrame = 0; //frame it was left at when it dropped out of activeAnimations
+		float measuredFrameLoadMs = 0; //at full size, worst of a few sampled frames (adaptiveBuffering only), 0 if not measured
+		float measuredFrameBytes = 0; //RAM a buffered frame takes
+		int lodLevel = 0; //which version of the frames the animation is loaded from
+		int sourceWidth = 0; //full (canvas) size of the image / frames, probed while checking. 0 if unknown
+		int sourceHeight = 0;
+		int numChannels = 0; //what the decoder will produce
+		int atlasIndex = -1; //static images packed in an atlas
+		ofRectangle atlasRect;
+		bool isTrimmed = false;
+		ofRectangle trimRect; //region of the canvas the frames hold, if trimmed
+		vector<int> uniqueFrames; //frame -> first frame with the same .dxt content (DXT only), filled while checking / compressing
+		int numUniqueFrames = 0;
 	};
 
 	State state = UNINITED; //global state of the object (loading, ready, etc)
@@ -110,44 +261,257 @@ protected:
 	unordered_map<string, ofTexture> images; //only static images
 	unordered_map<string, ofxImageSequenceVideo> animations; //only animations
 
+	//dense table behind AssetHandles; points straight into the maps above (their elements never move)
+	struct AssetSlot{
+		AssetType type;
+		AssetInfo * info = nullptr;
+		ofTexture * image = nullptr;
+		ofxImageSequenceVideo * animation = nullptr;
+	};
+	vector<AssetSlot> slots;
+	unordered_map<string, AssetHandle> handles;
+
+	//animations that need update() calls in READY: playing ones, ones handed out through getAnimation() recently
+	//(they might have been seeked while paused) and preloaded ones still uploading their frames. Idle ones drop
+	//out into idleAnimations, which only get a cheap isPlaying() / current frame check per frame, in case they
+	//get played or seeked through a reference the app kept.
+	struct ActiveAnimation{
+		ofxImageSequenceVideo * animation;
+		AssetInfo * info;
+	};
+	vector<ActiveAnimation> activeAnimations;
+	vector<ActiveAnimation> idleAnimations;
+	void activate(const string & ID); //call whenever an animation might need updating
+	const uint64_t activeGraceMS = 2000; //how long a touched animation stays active even if not playing
+
 	// PROCESS ASSETS /////////////////////////////
 
-	struct ProgressInfo{
-		float pct = 0;
+	struct ProgressInfo{ //written by the workers, read by getStatus(); shared so the maps can change under them
+		std::atomic<float> pct{0};
 	};
 
 	//check assets stage
-	vector<string> pendingCheck;
 	map<string, CheckInfo> checked;
-	vector<std::future<CheckInfo>> checkTasks;
-	map<string, ProgressInfo> checkProgress;
+	int numCheckTasks = 0; //submitted to the worker pool and not yet gathered
+	map<string, shared_ptr<ProgressInfo>> checkProgress;
 
 	//compress assets stage
-	vector<string> pendingCompression;
 	map<string, CompressInfo> compressed;
-	vector<std::future<CompressInfo>> compressTasks;
-	map<string, ProgressInfo> compressProgress;
+	int numCompressTasks = 0; //submitted to the worker pool and not yet gathered
+	map<string, shared_ptr<ProgressInfo>> compressProgress;
 
 	//preload assets stage
-	vector<string> pendingPreload;
+	std::deque<string> pendingPreload; //animations to preload
 	vector<string> preloaded;
 
+	//static images are decoded on the worker pool, only the texture upload happens on the main thread
+	struct DecodedImage{
+		string ID;
+		ofPixels pixels; //empty if it went into an atlas
+	};
+	int numPendingDecodes = 0; //submitted to the worker pool and not yet gathered
+	ofxAnimationAssetManagerCompletionQueue<DecodedImage> finishedDecodes;
+	std::deque<DecodedImage> pendingUploads;
+	PreloadPlan preloadPlan;
+	float preloadTimeBudgetMS = 0;
+	float getPreloadTimeBudget(); //ms, resolves the "0 = auto" setting
+	float estimatedPreloadMsPerMB = 1.0; //static image uploads, measured as we go
+	float estimatedPreloadMsPerAnimation = 0.1; //measured as we go
+
+	//static image atlases
+	struct Atlas{
+		ofTexture texture;
+		ofPixels pixels; //the workers paste the decoded images in, freed after the upload
+		int pendingImages = 0;
+	};
+	vector<unique_ptr<Atlas>> atlases;
+	float atlasVRAM = 0; //MB
+	bool atlasingEnabled = false;
+	int maxAtlasImageSize = 256;
+	int atlasSize = 2048;
+	void buildAtlases(const vector<string> & staticImageIDs); //assigns atlas rects, needs the image sizes
+
+	//runtime VRAM residency (READY state)
+	void updateResidency();
+	float getResidentVRAM(); //MB, static images + preloaded animations + one frame of each streamed one
+	void promote(const string & ID);
+	void evict(const string & ID);
+	bool residencyEnabled = true;
+	uint64_t residencyCheckIntervalMS = 1000;
+	uint64_t hotAfterMS = 2000;
+	uint64_t coldAfterMS = 30000;
+	uint64_t lastResidencyCheckMS = 0;
+
+	//prefetching (READY state)
+	struct PrefetchRequest{
+		uint64_t deadlineMS; //absolute, in ofGetElapsedTimeMillis() time
+		string ID;
+		int startFrame;
+		bool operator>(const PrefetchRequest & o) const {return deadlineMS > o.deadlineMS;}
+	};
+	std::priority_queue<PrefetchRequest, vector<PrefetchRequest>, std::greater<PrefetchRequest>> prefetchQueue; //earliest deadline on top
+	ofxAnimationAssetManagerCompletionQueue<PrefetchRequest> finishedPrefetches;
+	vector<PrefetchRequest> cuedPrefetches; //warmed up, waiting for their deadline to seek
+	int numPrefetchJobs = 0; //on the worker pool
+	void updatePrefetch();
+	static void warmFrames(const vector<string> & paths); //runs on the workers
+
+	//LODs
+	static string getLodFolder(const string & folder, int level); //level 0 is the folder itself
+	string getFramesFolder(const string & ID); //where an animation loads its frames from, at its current LOD
+	int pickLodLevel(const string & ID, float w, float h);
+	static void halfSize(const ofPixels & src, ofPixels & dst); //2x2 box filter
+
+	//adaptive buffering
+	void measureFrameLoad(const string & ID, const vector<string> & frames, bool dxt, bool justRead); //runs on the workers
+	static float timeFrameLoad(const string & path, bool dxt, float & bytes); //ms, -1 if it can't be loaded
+	void planAdaptiveBuffers(); //fills in bufferFrames & numThreads of the adaptive animations
+	void updateAdaptiveBuffers(); //READY: playback sampling, re-planning & applying the new buffers
+	struct AdaptiveAnimation{
+		string ID;
+		ofxImageSequenceVideo * animation;
+		AssetInfo * info;
+		AssetLoadOptions * options; //the plan
+		int bufferFrames = 0; //what the animation is set up with
+		int numThreads = 0;
+		uint64_t lastSampleMS = 0;
+		bool isSampling = false; //a frame load is being timed on the workers
+	};
+	vector<AdaptiveAnimation> adaptiveAnimations; //filled at PRELOADING_ASSETS
+	struct FrameLoadSample{
+		string ID;
+		float ms; //-1 if the frame couldn't be loaded
+		float bytes;
+	};
+	ofxAnimationAssetManagerCompletionQueue<FrameLoadSample> frameLoadSamples;
+	const uint64_t frameLoadSampleIntervalMS = 2000; //per playing animation
+	float maxBufferRAM = 1024; //MB
+	int maxAdaptiveThreads = 4;
+	int maxAdaptiveBufferFrames = 60;
+
+	//0/1 knapsack: indices of the items that maximize total value within capacity
+	static vector<int> solveKnapsack(const vector<float> & sizes, const vector<float> & values, float capacity);
+
 	// THREAD PROCESS METHODS /////////////////////////////
 
-	CheckInfo checkAsset(string ID, ProgressInfo * progress);
-	CompressInfo compressAsset(string ID, ProgressInfo * progress);
+	//every load gets its own token. Background work holds on to the token it was started with and checks it
+	//often (per frame, per row of DXT blocks, per MB hashed) so a cancelled load winds down right away
+	typedef shared_ptr<std::atomic<bool>> CancelToken;
+	CancelToken cancelToken;
+	static bool isCancelled(const CancelToken & t){return t && *t;}
+
+	struct CompressJob{ //shared by all the per-frame tasks of one asset
+		string ID;
+		vector<string> frames; //all of them, in order
+		int numToCompress = 0; //how many of them go through the pipeline
+		int lodLevels = 0; //smaller versions baked along with each frame
+		//trimming goes over the frames twice: first to find their alpha bounds, then to bake the region they cover
+		ofxAnimationAssetManagerManifest::Trim trim;
+		ofxAnimationAssetManagerManifest::Rect oldTrimRect; //what the existing .dxt files were cropped to
+		std::atomic<bool> scanning{false};
+		vector<bool> queued; //frames that went through the first pass
+		std::atomic<int> numDone{0};
+		std::atomic<bool> failed{false};
+		shared_ptr<ProgressInfo> progress;
+		vector<ofxAnimationAssetManagerManifest::Frame> manifestFrames; //one slot per frame, each task fills its own (the rest come from the old manifest)
+		uint64_t startMicros = 0;
+		CancelToken cancel;
+	};
+
+	CheckInfo checkAsset(string ID, shared_ptr<ProgressInfo> progress, CancelToken cancel);
+	//lists the frames and feeds the ones in framesToCompress (or without a .dxt file) to the compression pipeline
+	void compressAsset(string ID, shared_ptr<ProgressInfo> progress, CancelToken cancel, const vector<string> & framesToCompress);
+	void onAssetCompressed(shared_ptr<CompressJob> job); //runs on the pool once the last frame is written
+	void onAssetScanned(shared_ptr<CompressJob> job); //same, after the alpha bounds pass of a trimmed animation
+	//hard link the .dxt (and LOD) files of identical frames to the first one; fixes up the frames' manifest entries
+	void linkDuplicateFrames(shared_ptr<CompressJob> job);
+	void indexDuplicateFrames(const string & ID, const vector<ofxAnimationAssetManagerManifest::Frame> & frames); //runs on the workers
+
+	ofxAnimationAssetManagerWorkerPool workers; //long lived, sized by numThreadsToUse
+
+	// COMPRESSION PIPELINE /////////////////////////////
+	// reader thread (file -> memory) >> worker pool (decode + DXT encode) >> writer thread (.dxt -> disk)
+	// so disk and CPU work overlap. The number of frames in flight is bounded to keep memory in check.
+
+	struct FrameTask{
+		shared_ptr<CompressJob> job;
+		int frameIndex = 0;
+		ofBuffer fileData;			//filled by the reader
+		ofxDXT::Data compressed;	//filled by the workers
+		vector<ofxDXT::Data> lodCompressed; //one per LOD level, filled by the workers
+		vector<ofBuffer> lodImages; //same, re-encoded to the source format so the LOD folder is a sequence of its own
+		bool ok = false;
+	};
+
+	void startCompressionPipeline();
+	void stopCompressionPipeline();
+	void readerLoop();
+	void writerLoop();
+	void encodeFrame(shared_ptr<FrameTask> task); //runs on the worker pool
+	void finishFrame(shared_ptr<FrameTask> task);
+
+	std::thread readerThread;
+	std::thread writerThread;
+	std::mutex pipelineMutex;
+	std::condition_variable pipelineChanged;
+	std::deque<shared_ptr<FrameTask>> readQueue;
+	std::deque<shared_ptr<FrameTask>> writeQueue;
+	int framesInFlight = 0; //read but not yet written
+	int maxFramesInFlight = 1;
+	bool pipelineRunning = false;
+
+	ofxAnimationAssetManagerDxtEncoder dxtEncoder;
+	ofxAnimationAssetManagerDxtEncoder::Backend compressionBackend = ofxAnimationAssetManagerDxtEncoder::BACKEND_OFXDXT;
+
+	//results handed back from the worker threads, drained on the main thread at update()
+	ofxAnimationAssetManagerCompletionQueue<CheckInfo> finishedChecks;
+	ofxAnimationAssetManagerCompletionQueue<CompressInfo> finishedCompressions;
+
+	// STATS //////////////////////////////////////
+
+	struct AssetCounters{ //written from any thread
+		std::atomic<uint64_t> bytesRead{0};
+		std::atomic<uint64_t> bytesWritten{0};
+		std::atomic<int> framesCompressed{0};
+		std::atomic<uint64_t> checkMicros{0};
+		std::atomic<uint64_t> compressMicros{0};
+	};
+	unordered_map<string, unique_ptr<AssetCounters>> counters; //one per asset, all created at startLoading()
+	AssetCounters * getCounters(const string & ID); //nullptr if none
+
+	Stats stats; //finished stages
+	Stats::LatencyRecorder readLatency;
+	Stats::LatencyRecorder decodeLatency;
+	Stats::LatencyRecorder encodeLatency;
+	Stats::LatencyRecorder writeLatency;
+	Stats::LatencyRecorder uploadLatency;
+	uint64_t loadStartMicros = 0;
+	uint64_t stageStartMicros = 0;
+	uint64_t stageStartBusyMicros = 0;
+	int peakFramesInFlight = 0; //guarded by pipelineMutex
+
+	void resetStats();
+	void fillStage(Stats::Stage & stage, uint64_t now); //with the numbers of the stage that started at stageStartMicros
+	void onStageChange(State from, State to);
 
 	// UTILS //////////////////////////////////////
 
 	std::string bytesToHumanReadable(long long bytes, int decimalPrecision);
+	//single pass over an animation folder; source images (sorted) and the names of all .dxt files in it
+	static void listAnimationFolder(const string & folder, vector<string> & images, unordered_set<string> & dxtFiles);
+	static shared_ptr<const FolderListing> scanFolder(const string & folder, int lodLevels);
+	//size & channels of a PNG / TGA from its header alone (no decoding); false if it's neither
+	static bool probeImage(const string & path, int & width, int & height, int & numChannels);
+	void probeAsset(const string & ID, const string & imagePath); //fills in the AssetInfo sizes, runs on the workers
+	uint64_t estimateAnimationVRAM(const string & ID); //bytes to preload it at its current LOD, from the probed size
 
 	// STATE ///////////////////////////////////////
 
 	void setState(State s);
 
-	bool needsToStop = false; //to handle obj destruction
 	int numThreadsToUse = 1;
 	float maxUsedVRAM = 0; //in Mbytes - provided at setup
+	CacheValidation cacheValidation = VALIDATE_CACHE_FAST;
 	map<string, AssetLoadOptions> assetLoadOptions;
 	bool isSetup = false;
 
@@ -0,0 +1,67 @@
+//
+//  ofxAnimationAssetManagerCompletionQueue.h
+//  ofxAnimationAssetManager
+//
+//  Lock-free multiple producer / single consumer queue, used to hand results
+//  from the worker threads back to the main thread.
+//
+//  Producers push onto an intrusive stack with a CAS; the consumer grabs the
+//  whole stack in one atomic exchange and walks it in push order. Taking
+//  everything at once means there is no single-node pop, so no ABA problem.
+//
+//
+
+#pragma once
+#include "ofMain.h"
+
+template<typename T>
+class ofxAnimationAssetManagerCompletionQueue{
+
+public:
+
+	ofxAnimationAssetManagerCompletionQueue(){}
+	~ofxAnimationAssetManagerCompletionQueue(){ clear(); }
+	ofxAnimationAssetManagerCompletionQueue(const ofxAnimationAssetManagerCompletionQueue &) = delete;
+	ofxAnimationAssetManagerCompletionQueue & operator=(const ofxAnimationAssetManagerCompletionQueue &) = delete;
+
+	//any thread
+	void push(T value){
+		Node * n = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+		while(!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)){}
+	}
+
+	//consumer thread only. Calls f(T&&) for every item pushed so far, oldest first; returns how many
+	template<typename F>
+	size_t drain(F f){
+		Node * n = head.exchange(nullptr, std::memory_order_acquire);
+		//the stack is newest first, flip it
+		Node * ordered = nullptr;
+		while(n){
+			Node * next = n->next;
+			n->next = ordered;
+			ordered = n;
+			n = next;
+		}
+		size_t count = 0;
+		while(ordered){
+			Node * next = ordered->next;
+			f(std::move(ordered->value));
+			delete ordered;
+			ordered = next;
+			count++;
+		}
+		return count;
+	}
+
+	void clear(){ drain([](T &&){}); }
+	bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+protected:
+
+	struct Node{
+		T value;
+		Node * next;
+	};
+
+	std::atomic<Node*> head{nullptr};
+};
@@ -0,0 +1,939 @@
+//
+//  ofxAnimationAssetManagerDxtEncoder.cpp
+//  ofxAnimationAssetManager
+//
+//
+
+#include "ofxAnimationAssetManagerDxtEncoder.h"
+#include "stb_dxt.h" //implementation lives in ofxDXT
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define AAM_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define AAM_TARGET(x)
+	#else
+		#define AAM_TARGET(x) __attribute__((target(x)))
+	#endif
+#else
+	#define AAM_X86 0
+#endif
+
+#if defined(_MSC_VER)
+	#define AAM_FORCE_INLINE __forceinline
+#else
+	#define AAM_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+
+// BLOCK GATHER //////////////////////////////////////////////////////////////////////
+// copy a 4x4 block (4 rows of 16 bytes) out of the image and tell if all its pixels are equal
+
+static inline bool gatherBlockScalar(const unsigned char * src, size_t stride, unsigned char * block){
+	for(int row = 0; row < 4; row++){
+		memcpy(block + row * 16, src + row * stride, 16);
+	}
+	uint32_t px[16];
+	memcpy(px, block, 64);
+	for(int i = 1; i < 16; i++){
+		if(px[i] != px[0]) return false;
+	}
+	return true;
+}
+
+#if AAM_X86
+
+AAM_TARGET("sse4.1")
+static inline bool gatherBlockSSE41(const unsigned char * src, size_t stride, unsigned char * block){
+	__m128i r0 = _mm_loadu_si128((const __m128i*)(src));
+	__m128i r1 = _mm_loadu_si128((const __m128i*)(src + stride));
+	__m128i r2 = _mm_loadu_si128((const __m128i*)(src + stride * 2));
+	__m128i r3 = _mm_loadu_si128((const __m128i*)(src + stride * 3));
+	_mm_storeu_si128((__m128i*)(block), r0);
+	_mm_storeu_si128((__m128i*)(block + 16), r1);
+	_mm_storeu_si128((__m128i*)(block + 32), r2);
+	_mm_storeu_si128((__m128i*)(block + 48), r3);
+	__m128i first = _mm_shuffle_epi32(r0, 0);
+	__m128i eq = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(r0, first), _mm_cmpeq_epi32(r1, first)),
+							   _mm_and_si128(_mm_cmpeq_epi32(r2, first), _mm_cmpeq_epi32(r3, first)));
+	return _mm_test_all_ones(eq) != 0;
+}
+
+AAM_TARGET("avx2")
+static inline bool gatherBlockAVX2(const unsigned char * src, size_t stride, unsigned char * block){
+	__m128i r0 = _mm_loadu_si128((const __m128i*)(src));
+	__m128i r1 = _mm_loadu_si128((const __m128i*)(src + stride));
+	__m128i r2 = _mm_loadu_si128((const __m128i*)(src + stride * 2));
+	__m128i r3 = _mm_loadu_si128((const __m128i*)(src + stride * 3));
+	__m256i top = _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1);
+	__m256i bottom = _mm256_inserti128_si256(_mm256_castsi128_si256(r2), r3, 1);
+	_mm256_storeu_si256((__m256i*)(block), top);
+	_mm256_storeu_si256((__m256i*)(block + 32), bottom);
+	__m256i first = _mm256_broadcastd_epi32(r0);
+	__m256i eq = _mm256_and_si256(_mm256_cmpeq_epi32(top, first), _mm256_cmpeq_epi32(bottom, first));
+	return _mm256_movemask_epi8(eq) == -1;
+}
+
+#endif
+
+
+// BLOCK ENCODER /////////////////////////////////////////////////////////////////////
+// stb_dxt's block encoder (the 1.0x versions ofxDXT ships) with the per pixel work done on all 16 pixels of
+// the block at once: channel min / max / sums, covariance, the dot products along the color axis, the index
+// search and packing, the refine sums and the alpha indices. The little float math there is (power iteration,
+// least squares endpoints) is kept scalar and written exactly like stb's, so the output matches it bit for bit.
+// verifyAgainstStb() checks that on random blocks. Dithering isn't ported, that mode goes to stb per block.
+// A block is one 128 bit register per channel, so AVX2 only widens the gather; both levels share these kernels
+
+struct DxtTables{
+	unsigned char expand5[32];
+	unsigned char expand6[64];
+	unsigned char oMatch5[256][2];	//best (max, min) 5 bit endpoints to get a value as the 1/3 lerp
+	unsigned char oMatch6[256][2];
+
+	DxtTables(){
+		for(int i = 0; i < 32; i++) expand5[i] = (i << 3) | (i >> 2);
+		for(int i = 0; i < 64; i++) expand6[i] = (i << 2) | (i >> 4);
+		prepareOptTable(oMatch5, expand5, 32);
+		prepareOptTable(oMatch6, expand6, 64);
+	}
+
+	static void prepareOptTable(unsigned char table[256][2], const unsigned char * expand, int size){
+		for(int i = 0; i < 256; i++){
+			int bestErr = 256;
+			for(int mn = 0; mn < size; mn++){
+				for(int mx = 0; mx < size; mx++){
+					int mine = expand[mn];
+					int maxe = expand[mx];
+					int err = abs((2 * maxe + mine) / 3 - i) + abs(maxe - mine) * 3 / 100;
+					if(err < bestErr){
+						table[i][0] = mx;
+						table[i][1] = mn;
+						bestErr = err;
+					}
+				}
+			}
+		}
+	}
+};
+
+static const DxtTables & dxtTables(){
+	static const DxtTables tables;
+	return tables;
+}
+
+static inline int mul8Bit(int a, int b){
+	int t = a * b + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+static inline unsigned short as16Bit(int r, int g, int b){
+	return (mul8Bit(r, 31) << 11) + (mul8Bit(g, 63) << 5) + mul8Bit(b, 31);
+}
+
+//the 4 colors of the palette, rgbx
+static void evalColors(unsigned char * color, unsigned short c0, unsigned short c1){
+	const DxtTables & t = dxtTables();
+	color[0] = t.expand5[c0 >> 11]; color[1] = t.expand6[(c0 >> 5) & 63]; color[2] = t.expand5[c0 & 31];
+	color[4] = t.expand5[c1 >> 11]; color[5] = t.expand6[(c1 >> 5) & 63]; color[6] = t.expand5[c1 & 31];
+	for(int c = 0; c < 3; c++){
+		color[8 + c] = (2 * color[c] + color[4 + c]) / 3;
+		color[12 + c] = (2 * color[4 + c] + color[c]) / 3;
+	}
+}
+
+//endpoints that best reproduce a single color
+static void singleColorEndpoints(int r, int g, int b, unsigned short & max16, unsigned short & min16){
+	const DxtTables & t = dxtTables();
+	max16 = (t.oMatch5[r][0] << 11) | (t.oMatch6[g][0] << 5) | t.oMatch5[b][0];
+	min16 = (t.oMatch5[r][1] << 11) | (t.oMatch6[g][1] << 5) | t.oMatch5[b][1];
+}
+
+//stb__OptimizeColorsBlock's float part: principal axis of the colors by power iteration, scaled to ints
+static void colorAxis(const int cov[6], const int minc[3], const int maxc[3], int v[3]){
+	float covf[6];
+	for(int i = 0; i < 6; i++) covf[i] = cov[i] / 255.0f;
+	float vfr = (float)(maxc[0] - minc[0]);
+	float vfg = (float)(maxc[1] - minc[1]);
+	float vfb = (float)(maxc[2] - minc[2]);
+	for(int iter = 0; iter < 4; iter++){
+		float r = vfr * covf[0] + vfg * covf[1] + vfb * covf[2];
+		float g = vfr * covf[1] + vfg * covf[3] + vfb * covf[4];
+		float b = vfr * covf[2] + vfg * covf[4] + vfb * covf[5];
+		vfr = r;
+		vfg = g;
+		vfb = b;
+	}
+	double magn = fabs(vfr);
+	if(fabs(vfg) > magn) magn = fabs(vfg);
+	if(fabs(vfb) > magn) magn = fabs(vfb);
+	if(magn < 4.0f){ //too small, default to luminance
+		v[0] = 299;
+		v[1] = 587;
+		v[2] = 114;
+	}else{
+		magn = 512.0 / magn;
+		v[0] = (int)(vfr * magn);
+		v[1] = (int)(vfg * magn);
+		v[2] = (int)(vfb * magn);
+	}
+}
+
+static inline int sclamp(float y, int p0, int p1){
+	int x = (int)y;
+	return x < p0 ? p0 : (x > p1 ? p1 : x);
+}
+
+//stb__RefineBlock's float part: least squares endpoints for the current indices
+static void leastSquaresEndpoints(const int at1[3], const int at2[3], int xx, int yy, int xy,
+								  unsigned short & max16, unsigned short & min16){
+	float frb = 3.0f * 31.0f / 255.0f / (xx * yy - xy * xy);
+	float fg = frb * 63.0f / 31.0f;
+	max16 = sclamp((at1[0] * yy - at2[0] * xy) * frb + 0.5f, 0, 31) << 11;
+	max16 |= sclamp((at1[1] * yy - at2[1] * xy) * fg + 0.5f, 0, 63) << 5;
+	max16 |= sclamp((at1[2] * yy - at2[2] * xy) * frb + 0.5f, 0, 31);
+	min16 = sclamp((at2[0] * xx - at1[0] * xy) * frb + 0.5f, 0, 31) << 11;
+	min16 |= sclamp((at2[1] * xx - at1[1] * xy) * fg + 0.5f, 0, 63) << 5;
+	min16 |= sclamp((at2[2] * xx - at1[2] * xy) * frb + 0.5f, 0, 31);
+}
+
+static inline int lowestSetBit(uint32_t bits){
+	#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward(&i, bits);
+	return i;
+	#else
+	return __builtin_ctz(bits);
+	#endif
+}
+
+static inline void encodeBlockStb(const unsigned char * block, bool withAlpha, int stbMode, unsigned char * dest){
+	stb_compress_dxt_block(dest, block, withAlpha ? 1 : 0, stbMode);
+}
+
+#if AAM_X86
+
+struct BlockSSE41{
+	__m128i px[4];		//the 4 rows, rgba
+	__m128i ch[4];		//r, g, b & a of the 16 pixels
+	int sum[3];
+};
+
+AAM_TARGET("sse4.1")
+static inline int sumInt32SSE41(__m128i v){
+	v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(v);
+}
+
+AAM_TARGET("sse4.1")
+static inline int sumBytesSSE41(__m128i v){
+	__m128i s = _mm_sad_epu8(v, _mm_setzero_si128());
+	return _mm_cvtsi128_si32(s) + _mm_extract_epi32(s, 2);
+}
+
+AAM_TARGET("sse4.1")
+static inline int minBytesSSE41(__m128i v){
+	v = _mm_min_epu8(v, _mm_srli_si128(v, 8));
+	v = _mm_min_epu8(v, _mm_srli_si128(v, 4));
+	v = _mm_min_epu8(v, _mm_srli_si128(v, 2));
+	v = _mm_min_epu8(v, _mm_srli_si128(v, 1));
+	return _mm_cvtsi128_si32(v) & 255;
+}
+
+AAM_TARGET("sse4.1")
+static inline int maxBytesSSE41(__m128i v){
+	v = _mm_max_epu8(v, _mm_srli_si128(v, 8));
+	v = _mm_max_epu8(v, _mm_srli_si128(v, 4));
+	v = _mm_max_epu8(v, _mm_srli_si128(v, 2));
+	v = _mm_max_epu8(v, _mm_srli_si128(v, 1));
+	return _mm_cvtsi128_si32(v) & 255;
+}
+
+//r * px.r + g * px.g + b * px.b of every pixel, in pixel order
+AAM_TARGET("sse4.1")
+static inline void dotsSSE41(const BlockSSE41 & blk, int r, int g, int b, __m128i dots[4]){
+	const __m128i w = _mm_setr_epi16(r, g, b, 0, r, g, b, 0);
+	for(int i = 0; i < 4; i++){
+		__m128i lo = _mm_madd_epi16(_mm_cvtepu8_epi16(blk.px[i]), w);
+		__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(blk.px[i], _mm_setzero_si128()), w);
+		dots[i] = _mm_hadd_epi32(lo, hi);
+	}
+}
+
+//index of the first pixel whose dot equals value (broadcast)
+AAM_TARGET("sse4.1")
+static inline int firstIndexOfSSE41(const __m128i dots[4], __m128i value){
+	uint32_t bits = 0;
+	for(int i = 0; i < 4; i++){
+		bits |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dots[i], value))) << (i * 4);
+	}
+	return lowestSetBit(bits);
+}
+
+//stb__MatchColorsBlock: nearest palette entry of each pixel along c0 - c1. Also returns the 2 bit
+//indices one per byte, which is what the refine step wants
+AAM_TARGET("sse4.1")
+static uint32_t matchColorsSSE41(const BlockSSE41 & blk, const unsigned char * color, __m128i & indices){
+	int dirr = color[0] - color[4];
+	int dirg = color[1] - color[5];
+	int dirb = color[2] - color[6];
+	int stops[4];
+	for(int i = 0; i < 4; i++){
+		stops[i] = color[i * 4] * dirr + color[i * 4 + 1] * dirg + color[i * 4 + 2] * dirb;
+	}
+	const __m128i c0Point = _mm_set1_epi32(stops[1] + stops[3]);
+	const __m128i halfPoint = _mm_set1_epi32(stops[3] + stops[2]);
+	const __m128i c3Point = _mm_set1_epi32(stops[2] + stops[0]);
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128i three = _mm_set1_epi32(3);
+
+	__m128i dots[4], idx[4];
+	dotsSSE41(blk, dirr, dirg, dirb, dots);
+	for(int i = 0; i < 4; i++){
+		__m128i dot = _mm_add_epi32(dots[i], dots[i]);
+		__m128i belowHalf = _mm_xor_si128(three, _mm_and_si128(_mm_cmplt_epi32(dot, c0Point), two)); //1 : 3
+		__m128i aboveHalf = _mm_and_si128(_mm_cmplt_epi32(dot, c3Point), two); //2 : 0
+		idx[i] = _mm_blendv_epi8(aboveHalf, belowHalf, _mm_cmplt_epi32(dot, halfPoint));
+	}
+	indices = _mm_packus_epi16(_mm_packs_epi32(idx[0], idx[1]), _mm_packs_epi32(idx[2], idx[3]));
+
+	//2 bits per pixel, pixel 0 in the lowest bits
+	__m128i pairs = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0401));
+	__m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00100001));
+	quads = _mm_shuffle_epi8(quads, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+	return _mm_cvtsi128_si32(quads);
+}
+
+//stb__RefineBlock: new endpoints for the current indices, returns true if they changed
+AAM_TARGET("sse4.1")
+static bool refineBlockSSE41(const BlockSSE41 & blk, uint32_t mask, __m128i indices, unsigned short & max16, unsigned short & min16){
+	unsigned short newMax, newMin;
+	if((mask ^ (mask << 2)) < 4){ //all indices the same, use the average color
+		singleColorEndpoints((blk.sum[0] + 8) >> 4, (blk.sum[1] + 8) >> 4, (blk.sum[2] + 8) >> 4, newMax, newMin);
+	}else{
+		//weight of max16 for each index is w1 = {3, 0, 2, 1}, min16's is 3 - w1
+		__m128i w1 = _mm_shuffle_epi8(_mm_setr_epi8(3, 0, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), indices);
+		int xx = sumBytesSSE41(_mm_shuffle_epi8(_mm_setr_epi8(9, 0, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), indices));
+		int yy = sumBytesSSE41(_mm_shuffle_epi8(_mm_setr_epi8(0, 9, 1, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), indices));
+		int xy = sumBytesSSE41(_mm_shuffle_epi8(_mm_setr_epi8(0, 0, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), indices));
+		int at1[3], at2[3];
+		for(int c = 0; c < 3; c++){
+			at1[c] = sumInt32SSE41(_mm_madd_epi16(_mm_maddubs_epi16(blk.ch[c], w1), _mm_set1_epi16(1)));
+			at2[c] = 3 * blk.sum[c] - at1[c];
+		}
+		leastSquaresEndpoints(at1, at2, xx, yy, xy, newMax, newMin);
+	}
+	bool changed = newMax != max16 || newMin != min16;
+	max16 = newMax;
+	min16 = newMin;
+	return changed;
+}
+
+//stb__CompressColorBlock without dithering
+AAM_TARGET("sse4.1")
+static void encodeColorBlockSSE41(BlockSSE41 & blk, bool withAlpha, int stbMode, unsigned char * dest){
+
+	uint32_t mask;
+	unsigned short max16, min16;
+
+	//BC3 encodes the color with alpha forced to 255, BC1 compares the whole pixels
+	const __m128i colorBits = _mm_set1_epi32(withAlpha ? 0x00FFFFFF : -1);
+	__m128i first = _mm_shuffle_epi32(_mm_and_si128(blk.px[0], colorBits), 0);
+	__m128i eq = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(blk.px[0], colorBits), first),
+											 _mm_cmpeq_epi32(_mm_and_si128(blk.px[1], colorBits), first)),
+								_mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(blk.px[2], colorBits), first),
+											 _mm_cmpeq_epi32(_mm_and_si128(blk.px[3], colorBits), first)));
+
+	if(_mm_test_all_ones(eq)){
+		uint32_t c = _mm_cvtsi128_si32(first);
+		singleColorEndpoints(c & 255, (c >> 8) & 255, (c >> 16) & 255, max16, min16);
+		mask = 0xaaaaaaaa;
+	}else{
+		//channel stats & covariance around the mean
+		int cov[6], minc[3], maxc[3];
+		__m128i d[3][2];
+		for(int c = 0; c < 3; c++){
+			blk.sum[c] = sumBytesSSE41(blk.ch[c]);
+			minc[c] = minBytesSSE41(blk.ch[c]);
+			maxc[c] = maxBytesSSE41(blk.ch[c]);
+			__m128i mu = _mm_set1_epi16((blk.sum[c] + 8) >> 4);
+			d[c][0] = _mm_sub_epi16(_mm_cvtepu8_epi16(blk.ch[c]), mu);
+			d[c][1] = _mm_sub_epi16(_mm_unpackhi_epi8(blk.ch[c], _mm_setzero_si128()), mu);
+		}
+		static const int pairs[6][2] = {{0, 0}, {0, 1}, {0, 2}, {1, 1}, {1, 2}, {2, 2}};
+		for(int i = 0; i < 6; i++){
+			const __m128i * a = d[pairs[i][0]];
+			const __m128i * b = d[pairs[i][1]];
+			cov[i] = sumInt32SSE41(_mm_add_epi32(_mm_madd_epi16(a[0], b[0]), _mm_madd_epi16(a[1], b[1])));
+		}
+
+		//endpoints: the pixels at both ends of the principal axis
+		int v[3];
+		colorAxis(cov, minc, maxc, v);
+		__m128i dots[4];
+		dotsSSE41(blk, v[0], v[1], v[2], dots);
+		__m128i mn = _mm_min_epi32(_mm_min_epi32(dots[0], dots[1]), _mm_min_epi32(dots[2], dots[3]));
+		__m128i mx = _mm_max_epi32(_mm_max_epi32(dots[0], dots[1]), _mm_max_epi32(dots[2], dots[3]));
+		mn = _mm_min_epi32(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+		mx = _mm_max_epi32(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+		mn = _mm_min_epi32(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+		mx = _mm_max_epi32(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+		int minp = firstIndexOfSSE41(dots, mn);
+		int maxp = firstIndexOfSSE41(dots, mx);
+		uint32_t pixels[16];
+		memcpy(pixels, blk.px, 64);
+		max16 = as16Bit(pixels[maxp] & 255, (pixels[maxp] >> 8) & 255, (pixels[maxp] >> 16) & 255);
+		min16 = as16Bit(pixels[minp] & 255, (pixels[minp] >> 8) & 255, (pixels[minp] >> 16) & 255);
+
+		unsigned char color[16];
+		__m128i indices = _mm_setzero_si128();
+		if(max16 != min16){
+			evalColors(color, max16, min16);
+			mask = matchColorsSSE41(blk, color, indices);
+		}else{
+			mask = 0;
+		}
+
+		int refineCount = (stbMode & STB_DXT_HIGHQUAL) ? 2 : 1;
+		for(int i = 0; i < refineCount; i++){
+			uint32_t lastMask = mask;
+			if(refineBlockSSE41(blk, mask, indices, max16, min16)){
+				if(max16 != min16){
+					evalColors(color, max16, min16);
+					mask = matchColorsSSE41(blk, color, indices);
+				}else{
+					mask = 0;
+					break;
+				}
+			}
+			if(mask == lastMask) break;
+		}
+	}
+
+	if(max16 < min16){
+		std::swap(max16, min16);
+		mask ^= 0x55555555;
+	}
+	dest[0] = max16 & 255;
+	dest[1] = max16 >> 8;
+	dest[2] = min16 & 255;
+	dest[3] = min16 >> 8;
+	dest[4] = mask & 255;
+	dest[5] = (mask >> 8) & 255;
+	dest[6] = (mask >> 16) & 255;
+	dest[7] = mask >> 24;
+}
+
+//stb__CompressAlphaBlock: 3 bit indices into 8 levels between max & min alpha
+AAM_TARGET("sse4.1")
+static void encodeAlphaBlockSSE41(__m128i alpha, unsigned char * dest){
+
+	int mn = minBytesSSE41(alpha);
+	int mx = maxBytesSSE41(alpha);
+	dest[0] = mx;
+	dest[1] = mn;
+
+	int dist = mx - mn;
+	int bias = (dist < 8) ? (dist - 1) : (dist / 2 + 2);
+	bias -= mn * 7;
+	const __m128i dist4 = _mm_set1_epi16(dist * 4);
+	const __m128i dist2 = _mm_set1_epi16(dist * 2);
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i two = _mm_set1_epi16(2);
+
+	__m128i idx[2];
+	__m128i a16[2] = {_mm_cvtepu8_epi16(alpha), _mm_unpackhi_epi8(alpha, _mm_setzero_si128())};
+	for(int i = 0; i < 2; i++){
+		__m128i a = _mm_add_epi16(_mm_mullo_epi16(a16[i], _mm_set1_epi16(7)), _mm_set1_epi16(bias));
+		__m128i t = _mm_cmpgt_epi16(a, _mm_set1_epi16(dist * 4 - 1)); //a >= dist4
+		__m128i ind = _mm_and_si128(t, _mm_set1_epi16(4));
+		a = _mm_sub_epi16(a, _mm_and_si128(t, dist4));
+		t = _mm_cmpgt_epi16(a, _mm_set1_epi16(dist * 2 - 1));
+		ind = _mm_add_epi16(ind, _mm_and_si128(t, two));
+		a = _mm_sub_epi16(a, _mm_and_si128(t, dist2));
+		ind = _mm_sub_epi16(ind, _mm_cmpgt_epi16(a, _mm_set1_epi16(dist - 1)));
+		ind = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), ind), _mm_set1_epi16(7));
+		idx[i] = _mm_xor_si128(ind, _mm_and_si128(_mm_cmpgt_epi16(two, ind), one));
+	}
+
+	//3 bits per pixel, pixel 0 in the lowest bits: 12 bits per group of 4 pixels
+	__m128i indices = _mm_packus_epi16(idx[0], idx[1]);
+	__m128i pairs = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0801));
+	__m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00400001));
+	uint64_t bits = uint64_t(_mm_cvtsi128_si32(quads)) | (uint64_t(_mm_extract_epi32(quads, 1)) << 12) |
+					(uint64_t(_mm_extract_epi32(quads, 2)) << 24) | (uint64_t(_mm_extract_epi32(quads, 3)) << 36);
+	for(int i = 0; i < 6; i++){
+		dest[2 + i] = (bits >> (i * 8)) & 255;
+	}
+}
+
+//same contract as stb_compress_dxt_block()
+AAM_TARGET("sse4.1")
+static void encodeBlockSSE41(const unsigned char * block, bool withAlpha, int stbMode, unsigned char * dest){
+
+	if(stbMode & STB_DXT_DITHER){
+		encodeBlockStb(block, withAlpha, stbMode, dest);
+		return;
+	}
+
+	BlockSSE41 blk;
+	const __m128i deinterleave = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+	__m128i s[4];
+	for(int i = 0; i < 4; i++){
+		blk.px[i] = _mm_loadu_si128((const __m128i*)(block + i * 16));
+		s[i] = _mm_shuffle_epi8(blk.px[i], deinterleave); //rrrr gggg bbbb aaaa
+	}
+	__m128i rg01 = _mm_unpacklo_epi32(s[0], s[1]);
+	__m128i rg23 = _mm_unpacklo_epi32(s[2], s[3]);
+	__m128i ba01 = _mm_unpackhi_epi32(s[0], s[1]);
+	__m128i ba23 = _mm_unpackhi_epi32(s[2], s[3]);
+	blk.ch[0] = _mm_unpacklo_epi64(rg01, rg23);
+	blk.ch[1] = _mm_unpackhi_epi64(rg01, rg23);
+	blk.ch[2] = _mm_unpacklo_epi64(ba01, ba23);
+	blk.ch[3] = _mm_unpackhi_epi64(ba01, ba23);
+
+	if(withAlpha){
+		encodeAlphaBlockSSE41(blk.ch[3], dest);
+		dest += 8;
+	}
+	encodeColorBlockSSE41(blk, withAlpha, stbMode, dest);
+}
+
+#endif
+
+
+// BLOCK LOOP ////////////////////////////////////////////////////////////////////////
+// the loop is force-inlined into one entry point per SIMD level, each compiled for that target, so
+// the gather and the block encoder (template parameters) inline into it too. Solid color blocks are
+// encoded once and then copied from a small cache
+
+struct SolidBlockCache{ //direct mapped, solid color -> encoded block
+	uint32_t color[256];
+	bool valid[256];
+	unsigned char block[256][16];
+	SolidBlockCache(){ memset(valid, 0, sizeof(valid)); }
+};
+
+typedef bool (*GatherFunc)(const unsigned char *, size_t, unsigned char *);
+typedef void (*EncodeFunc)(const unsigned char *, bool, int, unsigned char *);
+
+template<GatherFunc gather, EncodeFunc encode>
+static AAM_FORCE_INLINE bool compressBlocksImpl(const unsigned char * rgba, int width, int height, bool withAlpha, int stbMode, unsigned char * output,
+							   const std::atomic<bool> * cancel){
+
+	const size_t stride = size_t(width) * 4;
+	const int blockBytes = withAlpha ? 16 : 8;
+	const int blocksX = width / 4;
+	const int blocksY = height / 4;
+	SolidBlockCache cache;
+	unsigned char block[64];
+
+	for(int by = 0; by < blocksY; by++){
+		if(cancel && cancel->load(std::memory_order_relaxed)) return false;
+		const unsigned char * row = rgba + size_t(by) * 4 * stride;
+		unsigned char * dest = output + size_t(by) * blocksX * blockBytes;
+		for(int bx = 0; bx < blocksX; bx++){
+			bool solid = gather(row + bx * 16, stride, block);
+			if(solid){
+				uint32_t color;
+				memcpy(&color, block, 4);
+				int slot = (color * 2654435761u) >> 24;
+				if(!cache.valid[slot] || cache.color[slot] != color){
+					encode(block, withAlpha, stbMode, cache.block[slot]);
+					cache.color[slot] = color;
+					cache.valid[slot] = true;
+				}
+				memcpy(dest, cache.block[slot], blockBytes);
+			}else{
+				encode(block, withAlpha, stbMode, dest);
+			}
+			dest += blockBytes;
+		}
+	}
+	return true;
+}
+
+static bool compressBlocksScalar(const unsigned char * rgba, int width, int height, bool withAlpha, int stbMode, unsigned char * output,
+								 const std::atomic<bool> * cancel){
+	return compressBlocksImpl<gatherBlockScalar, encodeBlockStb>(rgba, width, height, withAlpha, stbMode, output, cancel);
+}
+
+#if AAM_X86
+
+AAM_TARGET("sse4.1")
+static bool compressBlocksSSE41(const unsigned char * rgba, int width, int height, bool withAlpha, int stbMode, unsigned char * output,
+								const std::atomic<bool> * cancel){
+	return compressBlocksImpl<gatherBlockSSE41, encodeBlockSSE41>(rgba, width, height, withAlpha, stbMode, output, cancel);
+}
+
+AAM_TARGET("avx2")
+static bool compressBlocksAVX2(const unsigned char * rgba, int width, int height, bool withAlpha, int stbMode, unsigned char * output,
+							   const std::atomic<bool> * cancel){
+	return compressBlocksImpl<gatherBlockAVX2, encodeBlockSSE41>(rgba, width, height, withAlpha, stbMode, output, cancel);
+}
+
+#endif
+
+
+bool ofxAnimationAssetManagerDxtEncoder::compressBlocks(const unsigned char * rgba, int width, int height, bool withAlpha,
+														int stbMode, SimdLevel level, unsigned char * output,
+														const std::atomic<bool> * cancel){
+	#if AAM_X86
+	if(level == SIMD_AVX2){
+		return compressBlocksAVX2(rgba, width, height, withAlpha, stbMode, output, cancel);
+	}
+	if(level == SIMD_SSE41){
+		return compressBlocksSSE41(rgba, width, height, withAlpha, stbMode, output, cancel);
+	}
+	#endif
+	return compressBlocksScalar(rgba, width, height, withAlpha, stbMode, output, cancel);
+}
+
+
+// ALPHA BOUNDS //////////////////////////////////////////////////////////////////////
+// first / last pixel with alpha > 0 in [begin, end) of a row; end / begin - 1 if there's none.
+// Alpha is the last channel: RGBA or grey + alpha
+
+template<int channels>
+static int findFirstAlphaScalar(const unsigned char * row, int begin, int end){
+	for(int x = begin; x < end; x++){
+		if(row[x * channels + channels - 1]) return x;
+	}
+	return end;
+}
+
+template<int channels>
+static int findLastAlphaScalar(const unsigned char * row, int begin, int end){
+	for(int x = end - 1; x >= begin; x--){
+		if(row[x * channels + channels - 1]) return x;
+	}
+	return begin - 1;
+}
+
+#if AAM_X86
+
+AAM_TARGET("sse4.1")
+static int findFirstAlphaSSE41(const unsigned char * row, int begin, int end){
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+	int x = begin;
+	for(; x + 4 <= end; x += 4){
+		if(!_mm_testz_si128(_mm_loadu_si128((const __m128i*)(row + x * 4)), alpha)) break;
+	}
+	return findFirstAlphaScalar<4>(row, x, end);
+}
+
+AAM_TARGET("sse4.1")
+static int findLastAlphaSSE41(const unsigned char * row, int begin, int end){
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+	int x = end;
+	for(; x - 4 >= begin; x -= 4){
+		if(!_mm_testz_si128(_mm_loadu_si128((const __m128i*)(row + (x - 4) * 4)), alpha)) break;
+	}
+	return findLastAlphaScalar<4>(row, begin, x);
+}
+
+AAM_TARGET("avx2")
+static int findFirstAlphaAVX2(const unsigned char * row, int begin, int end){
+	const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+	int x = begin;
+	for(; x + 8 <= end; x += 8){
+		if(!_mm256_testz_si256(_mm256_loadu_si256((const __m256i*)(row + x * 4)), alpha)) break;
+	}
+	return findFirstAlphaScalar<4>(row, x, end);
+}
+
+AAM_TARGET("avx2")
+static int findLastAlphaAVX2(const unsigned char * row, int begin, int end){
+	const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+	int x = end;
+	for(; x - 8 >= begin; x -= 8){
+		if(!_mm256_testz_si256(_mm256_loadu_si256((const __m256i*)(row + (x - 8) * 4)), alpha)) break;
+	}
+	return findLastAlphaScalar<4>(row, begin, x);
+}
+
+#endif
+
+template<int channels, int (*FindFirst)(const unsigned char *, int, int), int (*FindLast)(const unsigned char *, int, int)>
+static bool findAlphaBoundsImpl(const unsigned char * pixels, int width, int height, int & x0, int & y0, int & x1, int & y1){
+
+	auto row = [&](int y){ return pixels + size_t(y) * width * channels; };
+
+	//top & bottom rows with anything in them, full scans
+	for(y0 = 0; y0 < height; y0++){
+		x0 = FindFirst(row(y0), 0, width);
+		if(x0 < width) break;
+	}
+	if(y0 == height) return false;
+	x1 = FindLast(row(y0), x0, width) + 1;
+	for(y1 = height; y1 - 1 > y0; y1--){
+		int first = FindFirst(row(y1 - 1), 0, width);
+		if(first < width){
+			x0 = std::min(x0, first);
+			x1 = std::max(x1, FindLast(row(y1 - 1), first, width) + 1);
+			break;
+		}
+	}
+	//rows in between only need their margins looked at, which shrink as we go
+	for(int y = y0 + 1; y < y1 - 1; y++){
+		x0 = FindFirst(row(y), 0, x0);
+		x1 = std::max(x1, FindLast(row(y), x1, width) + 1);
+	}
+	return true;
+}
+
+
+bool ofxAnimationAssetManagerDxtEncoder::findAlphaBounds(const ofPixels & pix, int & x0, int & y0, int & x1, int & y1){
+
+	int w = pix.getWidth();
+	int h = pix.getHeight();
+	if(pix.getNumChannels() == 2){ //grey + alpha, not worth vectorizing
+		return findAlphaBoundsImpl<2, findFirstAlphaScalar<2>, findLastAlphaScalar<2>>(pix.getData(), w, h, x0, y0, x1, y1);
+	}
+	if(pix.getNumChannels() != 4){
+		x0 = y0 = 0;
+		x1 = w;
+		y1 = h;
+		return w > 0 && h > 0;
+	}
+	static const SimdLevel level = detectSimdLevel();
+	#if AAM_X86
+	if(level == SIMD_AVX2){
+		return findAlphaBoundsImpl<4, findFirstAlphaAVX2, findLastAlphaAVX2>(pix.getData(), w, h, x0, y0, x1, y1);
+	}
+	if(level == SIMD_SSE41){
+		return findAlphaBoundsImpl<4, findFirstAlphaSSE41, findLastAlphaSSE41>(pix.getData(), w, h, x0, y0, x1, y1);
+	}
+	#endif
+	return findAlphaBoundsImpl<4, findFirstAlphaScalar<4>, findLastAlphaScalar<4>>(pix.getData(), w, h, x0, y0, x1, y1);
+}
+
+
+// CPU DISPATCH //////////////////////////////////////////////////////////////////////
+
+ofxAnimationAssetManagerDxtEncoder::SimdLevel ofxAnimationAssetManagerDxtEncoder::detectSimdLevel(){
+
+	#if AAM_X86
+		#if defined(_MSC_VER)
+		int regs[4];
+		__cpuid(regs, 1);
+		bool sse41 = (regs[2] & (1 << 19)) != 0;
+		bool osxsave = (regs[2] & (1 << 27)) != 0;
+		bool avx = (regs[2] & (1 << 28)) != 0;
+		bool avx2 = false;
+		if(osxsave && avx && (_xgetbv(0) & 6) == 6){ //OS saves the ymm registers
+			__cpuidex(regs, 7, 0);
+			avx2 = (regs[1] & (1 << 5)) != 0;
+		}
+		#else
+		__builtin_cpu_init();
+		bool sse41 = __builtin_cpu_supports("sse4.1");
+		bool avx2 = __builtin_cpu_supports("avx2");
+		#endif
+		if(avx2) return SIMD_AVX2;
+		if(sse41) return SIMD_SSE41;
+	#endif
+	return SIMD_NONE;
+}
+
+
+string ofxAnimationAssetManagerDxtEncoder::toString(SimdLevel l){
+	switch(l){
+		case SIMD_NONE: return "SCALAR";
+		case SIMD_SSE41: return "SSE4.1";
+		case SIMD_AVX2: return "AVX2";
+	}
+	return "Unknown SimdLevel!";
+}
+
+
+// SETUP & ENCODE ////////////////////////////////////////////////////////////////////
+
+void ofxAnimationAssetManagerDxtEncoder::setup(Backend b){
+
+	backend = b;
+	if(backend == BACKEND_OFXDXT) return;
+
+	simdLevel = detectSimdLevel();
+
+	//find the stb_dxt mode ofxDXT uses by encoding the same image both ways
+	ofPixels testPix;
+	fillTestImage(testPix, 64, 64);
+	ofxDXT::Data reference;
+	ofxDXT::compressRgbaPixels(testPix, reference);
+
+	const int modes[] = {STB_DXT_NORMAL, STB_DXT_HIGHQUAL, STB_DXT_DITHER};
+	vector<unsigned char> blocks((64 / 4) * (64 / 4) * 16);
+	for(int mode : modes){
+		compressBlocks(testPix.getData(), 64, 64, true, mode, simdLevel, blocks.data());
+		ofxDXT::Data ours;
+		copyBlocksIntoData(blocks, 64, 64, ours);
+		if(sameData(ours, reference)){
+			stbMode = mode;
+			ofLogNotice("ofxAnimationAssetManagerDxtEncoder") << "using the " << toString(simdLevel) << " DXT encoder.";
+			return;
+		}
+	}
+	ofLogWarning("ofxAnimationAssetManagerDxtEncoder") << "SIMD encoder output doesn't match ofxDXT's! Falling back to ofxDXT.";
+	backend = BACKEND_OFXDXT;
+}
+
+
+bool ofxAnimationAssetManagerDxtEncoder::compressRgbaPixels(const ofPixels & pix, ofxDXT::Data & output, const std::atomic<bool> * cancel){
+
+	int w = pix.getWidth();
+	int h = pix.getHeight();
+	//partial edge blocks & non-RGBA inputs are left to ofxDXT, so we never disagree with it on those
+	if(backend != BACKEND_SIMD || pix.getNumChannels() != 4 || w % 4 != 0 || h % 4 != 0 || w == 0 || h == 0){
+		ofxDXT::compressRgbaPixels(pix, output);
+		return true;
+	}
+	vector<unsigned char> blocks(size_t(w / 4) * (h / 4) * 16);
+	if(!compressBlocks(pix.getData(), w, h, true, stbMode, simdLevel, blocks.data(), cancel)) return false;
+	copyBlocksIntoData(blocks, w, h, output);
+	return true;
+}
+
+
+void ofxAnimationAssetManagerDxtEncoder::copyBlocksIntoData(const vector<unsigned char> & blocks, int width, int height, ofxDXT::Data & output){
+	output.allocate(width, height, ofxDXT::DXT5);
+	memcpy(output.getData(), blocks.data(), blocks.size());
+}
+
+
+bool ofxAnimationAssetManagerDxtEncoder::sameData(ofxDXT::Data & a, ofxDXT::Data & b){
+	return a.size() == b.size() && memcmp(a.getData(), b.getData(), a.size()) == 0;
+}
+
+
+// VERIFY & BENCHMARK ////////////////////////////////////////////////////////////////
+
+int ofxAnimationAssetManagerDxtEncoder::verifyAgainstStb(SimdLevel level, int numBlocks, uint32_t seed){
+
+	//one row of blocks, each of a random kind
+	numBlocks = std::max(numBlocks, 1);
+	const int width = numBlocks * 4;
+	const size_t stride = size_t(width) * 4;
+	vector<unsigned char> rgba(stride * 4);
+	auto rnd = [&seed](){ seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+	for(int b = 0; b < numBlocks; b++){
+		unsigned char c0[4], c1[4];
+		for(int c = 0; c < 4; c++){
+			c0[c] = rnd() & 255;
+			c1[c] = rnd() & 255;
+		}
+		int kind = rnd() % 6;
+		int alphaKind = rnd() % 3; //opaque, random, 0 / 255
+		for(int i = 0; i < 16; i++){
+			unsigned char * px = rgba.data() + (i / 4) * stride + (b * 4 + i % 4) * 4;
+			for(int c = 0; c < 3; c++){
+				switch(kind){
+					case 0: px[c] = rnd() & 255; break; //noise
+					case 1: px[c] = (rnd() & 1) ? c0[c] : c1[c]; break; //2 colors
+					case 2: px[c] = std::min<int>(255, (c0[c] * (15 - i) + c1[c] * i) / 15 + rnd() % 3); break; //gradient
+					case 3: px[c] = c0[c]; break; //flat color
+					case 4: px[c] = std::min(255, c0[c] + int(rnd() % 4)); break; //low contrast
+					default: px[c] = c0[c]; break; //solid
+				}
+			}
+			if(kind == 5 || alphaKind == 0) px[3] = kind == 5 ? c0[3] : 255;
+			else if(alphaKind == 1) px[3] = rnd() & 255;
+			else px[3] = (rnd() & 1) ? 255 : 0;
+		}
+	}
+
+	int mismatches = 0;
+	unsigned char block[64], expected[16];
+	for(int withAlpha = 0; withAlpha < 2; withAlpha++){
+		const int blockBytes = withAlpha ? 16 : 8;
+		for(int mode : {STB_DXT_NORMAL, STB_DXT_HIGHQUAL}){
+			vector<unsigned char> output(size_t(numBlocks) * blockBytes);
+			compressBlocks(rgba.data(), width, 4, withAlpha != 0, mode, level, output.data());
+			for(int b = 0; b < numBlocks; b++){
+				for(int row = 0; row < 4; row++){
+					memcpy(block + row * 16, rgba.data() + row * stride + b * 16, 16);
+				}
+				stb_compress_dxt_block(expected, block, withAlpha, mode);
+				if(memcmp(expected, output.data() + size_t(b) * blockBytes, blockBytes) != 0) mismatches++;
+			}
+		}
+	}
+	if(mismatches){
+		ofLogError("ofxAnimationAssetManagerDxtEncoder") << toString(level) << " encoder differs from stb_dxt on " << mismatches
+			<< " of " << numBlocks * 4 << " blocks!";
+	}
+	return mismatches;
+}
+
+
+void ofxAnimationAssetManagerDxtEncoder::fillTestImage(ofPixels & pix, int width, int height){
+
+	//smooth color & alpha gradients with noise on top, so hardly any block is a solid color
+	pix.allocate(width, height, 4);
+	unsigned char * p = pix.getData();
+	uint32_t seed = 1234567;
+	for(int y = 0; y < height; y++){
+		for(int x = 0; x < width; x++){
+			unsigned char * px = p + (size_t(y) * width + x) * 4;
+			seed = seed * 1664525u + 1013904223u;
+			int noise = (seed >> 24) & 15;
+			px[0] = std::min(255, (x * 255) / width + noise);
+			px[1] = std::min(255, (y * 255) / height + int((seed >> 16) & 15));
+			px[2] = ((x ^ y) * 4 + noise) & 255;
+			px[3] = std::min(255, 64 + (x + y) * 191 / std::max(1, width + height - 2) + int((seed >> 8) & 7));
+		}
+	}
+}
+
+
+ofxAnimationAssetManagerDxtEncoder::BenchmarkResult ofxAnimationAssetManagerDxtEncoder::benchmark(int width, int height, int iterations){
+
+	ofPixels pix;
+	fillTestImage(pix, width - width % 4, height - height % 4);
+	return benchmark(pix, iterations);
+}
+
+
+ofxAnimationAssetManagerDxtEncoder::BenchmarkResult ofxAnimationAssetManagerDxtEncoder::benchmark(const ofPixels & source, int iterations){
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	BenchmarkResult r;
+	r.width = source.getWidth() - source.getWidth() % 4;
+	r.height = source.getHeight() - source.getHeight() % 4;
+	r.iterations = std::max(iterations, 1);
+
+	ofPixels pix = source;
+	if(pix.getNumChannels() != 4) pix.setNumChannels(4);
+	if(r.width != (int)pix.getWidth() || r.height != (int)pix.getHeight()) pix.crop(0, 0, r.width, r.height);
+
+	ofxAnimationAssetManagerDxtEncoder simd;
+	simd.setup(BACKEND_SIMD);
+	r.simdLevel = simd.getBackend() == BACKEND_SIMD ? simd.getSimdLevel() : SIMD_NONE;
+
+	ofxDXT::Data a, b;
+	auto t0 = Clock::now();
+	for(int i = 0; i < r.iterations; i++){
+		ofxDXT::compressRgbaPixels(pix, a);
+	}
+	auto t1 = Clock::now();
+	for(int i = 0; i < r.iterations; i++){
+		simd.compressRgbaPixels(pix, b);
+	}
+	auto t2 = Clock::now();
+
+	double mpix = r.width * double(r.height) / 1000000.0;
+	r.ofxDxtMs = std::chrono::duration<double, std::milli>(t1 - t0).count() / r.iterations;
+	r.simdMs = std::chrono::duration<double, std::milli>(t2 - t1).count() / r.iterations;
+	r.ofxDxtMPixPerSec = r.ofxDxtMs > 0 ? mpix / (r.ofxDxtMs / 1000.0) : 0;
+	r.simdMPixPerSec = r.simdMs > 0 ? mpix / (r.simdMs / 1000.0) : 0;
+	r.bitExact = sameData(a, b);
+
+	ofLogNotice("ofxAnimationAssetManagerDxtEncoder") << "benchmark " << r.width << "x" << r.height << " x" << r.iterations
+		<< ": ofxDXT " << r.ofxDxtMs << " ms/img, " << toString(r.simdLevel) << " " << r.simdMs << " ms/img"
+		<< (r.bitExact ? " (bit exact)" : " (OUTPUT DIFFERS!)");
+	return r;
+}
@@ -0,0 +1,96 @@
+//
+//  ofxAnimationAssetManagerDxtEncoder.h
+//  ofxAnimationAssetManager
+//
+//  Alternative to ofxDXT::compressRgbaPixels() for asset baking: a port of the
+//  stb_dxt block encoder ofxDXT uses, with the per pixel work of each block
+//  (channel stats, covariance, endpoint & index search, refine sums, alpha
+//  indices) done with SSE4.1 (AVX2 for the block gather, picked at runtime,
+//  plain stb_dxt as the scalar fallback). Solid color blocks are encoded once
+//  and then copied from a small cache.
+//
+//  The output is meant to be byte for byte identical to ofxDXT's; setup()
+//  verifies that on a noisy test image and falls back to plain ofxDXT if it
+//  isn't (e.g. an stb_dxt version with a different algorithm, or one built with
+//  FMA contraction). verifyAgainstStb() checks it block by block.
+//
+//
+
+#pragma once
+#include "ofMain.h"
+#include "ofxDXT.h"
+
+class ofxAnimationAssetManagerDxtEncoder{
+
+public:
+
+	enum Backend{
+		BACKEND_OFXDXT,				//ofxDXT::compressRgbaPixels() as is
+		BACKEND_SIMD		//SIMD port of stb_dxt's block encoder, solid color blocks encoded once & cached
+	};
+
+	enum SimdLevel{
+		SIMD_NONE,
+		SIMD_SSE41,
+		SIMD_AVX2
+	};
+
+	struct BenchmarkResult{
+		int width = 0;
+		int height = 0;
+		int iterations = 0;
+		SimdLevel simdLevel = SIMD_NONE;
+		double ofxDxtMs = 0;		//avg time per image
+		double simdMs = 0;		//avg time per image
+		double ofxDxtMPixPerSec = 0;
+		double simdMPixPerSec = 0;
+		bool bitExact = false;		//both outputs are identical
+	};
+
+	//pick the backend; BACKEND_SIMD runs a self test against ofxDXT and falls back to it on mismatch
+	void setup(Backend backend);
+
+	//same contract as ofxDXT::compressRgbaPixels() (DXT5 / BC3). Thread safe.
+	//Checks cancel (if any) every row of blocks; returns false if it got cancelled midway (ofxDXT can't be)
+	bool compressRgbaPixels(const ofPixels & pix, ofxDXT::Data & output, const std::atomic<bool> * cancel = nullptr);
+
+	Backend getBackend(){return backend;}
+	SimdLevel getSimdLevel(){return simdLevel;}
+	static SimdLevel detectSimdLevel();
+	static string toString(SimdLevel l);
+
+	//raw block compression of a 4-channel image into BC1 (8 bytes per block, alpha ignored) or
+	//BC3 (16 bytes per block). width & height must be multiples of 4. Returns false if cancelled.
+	static bool compressBlocks(const unsigned char * rgba, int width, int height, bool withAlpha,
+							   int stbMode, SimdLevel level, unsigned char * output,
+							   const std::atomic<bool> * cancel = nullptr);
+
+	//bounding box of the pixels with alpha > 0 (x1 / y1 exclusive), for trimming transparent borders. The
+	//transparent margins are scanned 4 / 8 pixels at a time (RGBA; grey + alpha is scanned per pixel).
+	//Images without alpha are all "opaque".
+	//Returns false if the image is fully transparent. Thread safe.
+	static bool findAlphaBounds(const ofPixels & pix, int & x0, int & y0, int & x1, int & y1);
+
+	//encodes numBlocks random blocks (noise, gradients, 2 colors, flat color with varying alpha, low contrast,
+	//solid) with compressBlocks() at the given level and with stb_compress_dxt_block(), in BC1 & BC3 and in
+	//the NORMAL & HIGHQUAL modes. Returns the number of blocks whose output differs; 0 means bit exact
+	static int verifyAgainstStb(SimdLevel level, int numBlocks, uint32_t seed = 1);
+
+	//micro benchmark of this encoder vs ofxDXT over a synthetic, noise textured RGBA image (few solid blocks)
+	static BenchmarkResult benchmark(int width, int height, int iterations);
+
+	//same over a given RGBA image, e.g. a real frame; cropped to a multiple of 4
+	static BenchmarkResult benchmark(const ofPixels & pix, int iterations);
+
+protected:
+
+	static void fillTestImage(ofPixels & pix, int width, int height);
+
+	//ofxDXT::Data glue, the only place that knows about its memory layout
+	static void copyBlocksIntoData(const vector<unsigned char> & blocks, int width, int height, ofxDXT::Data & output);
+	static bool sameData(ofxDXT::Data & a, ofxDXT::Data & b);
+
+	Backend backend = BACKEND_OFXDXT;
+	SimdLevel simdLevel = SIMD_NONE;
+	int stbMode = 0; //found by the self test, has to match the one ofxDXT uses
+};
@@ -0,0 +1,275 @@
+//
+//  ofxAnimationAssetManagerManifest.cpp
+//  ofxAnimationAssetManager
+//
+//
+
+#include "ofxAnimationAssetManagerManifest.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(TARGET_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+const string ofxAnimationAssetManagerManifest::fileName = "ofxAnimationAssetManager.manifest";
+
+#define MANIFEST_HEADER_V1 "ofxAnimationAssetManager manifest 1"
+#define MANIFEST_HEADER "ofxAnimationAssetManager manifest 2" //adds trimming info
+
+
+bool ofxAnimationAssetManagerManifest::load(const string & folder){
+
+	frames.clear();
+	trim = Trim();
+
+	std::ifstream file(folder + "/" + fileName);
+	if(!file.is_open()) return false;
+
+	string line;
+	if(!std::getline(file, line) || (line != MANIFEST_HEADER && line != MANIFEST_HEADER_V1)) return false;
+	bool v1 = line == MANIFEST_HEADER_V1;
+
+	size_t numFrames = 0;
+	if(!std::getline(file, line)) return false;
+	numFrames = strtoull(line.c_str(), nullptr, 10);
+
+	if(!v1){
+		if(!std::getline(file, line)) return false;
+		std::istringstream ss(line);
+		ss >> trim.enabled >> trim.canvasWidth >> trim.canvasHeight >> trim.rect.x >> trim.rect.y >> trim.rect.width >> trim.rect.height;
+		if(ss.fail()) return false;
+	}
+
+	for(size_t i = 0; i < numFrames; i++){
+		if(!std::getline(file, line)) return false;
+		std::istringstream ss(line);
+		Frame f;
+		ss >> f.sourceSize >> f.sourceModified >> f.dxtSize >> std::hex >> f.dxtHash >> std::dec;
+		if(!v1){
+			ss >> f.hasAlphaBounds >> f.alphaBounds.x >> f.alphaBounds.y >> f.alphaBounds.width >> f.alphaBounds.height;
+		}
+		if(ss.fail()) return false;
+		ss.get(); //skip the separator, the rest of the line is the name (can contain spaces)
+		std::getline(ss, f.name);
+		if(f.name.size() == 0) return false;
+		frames[f.name] = f;
+	}
+
+	//a manifest that was cut short while being written is not trusted
+	if(!std::getline(file, line) || line != "end"){
+		frames.clear();
+		return false;
+	}
+	return true;
+}
+
+
+bool ofxAnimationAssetManagerManifest::save(const string & folder){
+
+	vector<const Frame*> sorted;
+	for(auto & it : frames) sorted.push_back(&it.second);
+	std::sort(sorted.begin(), sorted.end(), [](const Frame * a, const Frame * b){ return a->name < b->name; });
+
+	//written in place (not through a rename) so the manifest's date ends up newer than the
+	//folder's; that's how we tell if anything was added / removed from the folder later on.
+	std::ofstream file(folder + "/" + fileName, std::ios::trunc);
+	if(!file.is_open()){
+		ofLogError("ofxAnimationAssetManagerManifest") << "can't write manifest at \"" << folder << "\"";
+		return false;
+	}
+	file << MANIFEST_HEADER << "\n" << sorted.size() << "\n";
+	file << trim.enabled << " " << trim.canvasWidth << " " << trim.canvasHeight << " " << trim.rect.x << " " << trim.rect.y << " " << trim.rect.width << " " << trim.rect.height << "\n";
+	for(auto f : sorted){
+		const Rect & b = f->alphaBounds;
+		file << f->sourceSize << " " << f->sourceModified << " " << f->dxtSize << " " << std::hex << f->dxtHash << std::dec << " "
+			 << f->hasAlphaBounds << " " << b.x << " " << b.y << " " << b.width << " " << b.height << " " << f->name << "\n";
+	}
+	file << "end\n";
+	return file.good();
+}
+
+
+const ofxAnimationAssetManagerManifest::Frame * ofxAnimationAssetManagerManifest::getFrame(const string & name) const{
+	auto it = frames.find(name);
+	if(it != frames.end()) return &it->second;
+	return nullptr;
+}
+
+
+void ofxAnimationAssetManagerManifest::setFrame(const Frame & f){
+	frames[f.name] = f;
+}
+
+
+bool ofxAnimationAssetManagerManifest::getFileStats(const string & path, uint64_t & size, int64_t & modified){
+
+	#if defined(TARGET_WIN32)
+	struct _stat64 st;
+	if(_stat64(path.c_str(), &st) != 0) return false;
+	modified = int64_t(st.st_mtime) * 1000000000LL;
+	#else
+	struct stat st;
+	if(stat(path.c_str(), &st) != 0) return false;
+	#if defined(TARGET_OSX)
+	modified = int64_t(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+	#else
+	modified = int64_t(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+	#endif
+	#endif
+	size = st.st_size;
+	return true;
+}
+
+
+static inline uint64_t rotl64(uint64_t x, int r){
+	return (x << r) | (x >> (64 - r));
+}
+
+
+uint64_t ofxAnimationAssetManagerManifest::hashBytes(const unsigned char * data, size_t len){
+
+	//simple multiply-rotate hash, 8 bytes at a time. Not cryptographic, just fast and good
+	//enough to notice a corrupt or half-written file.
+	const uint64_t k1 = 0x87C37B91114253D5ULL;
+	const uint64_t k2 = 0x4CF5AD432745937FULL;
+	uint64_t h = 0x9E3779B97F4A7C15ULL ^ len;
+
+	size_t numWords = len / 8;
+	for(size_t i = 0; i < numWords; i++){
+		uint64_t w;
+		memcpy(&w, data + i * 8, 8);
+		h ^= rotl64(w * k1, 31) * k2;
+		h = rotl64(h, 27) * 5 + 0x52DCE729;
+	}
+	uint64_t tail = 0;
+	for(size_t i = numWords * 8; i < len; i++){
+		tail = (tail << 8) | data[i];
+	}
+	h ^= rotl64(tail * k1, 31) * k2;
+
+	//final avalanche
+	h ^= h >> 33; h *= 0xFF51AFD7ED558CCDULL;
+	h ^= h >> 33; h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+
+uint64_t ofxAnimationAssetManagerManifest::hashFile(const string & path, bool & ok, const std::atomic<bool> * cancel){
+
+	std::ifstream file(path, std::ios::binary);
+	ok = file.is_open();
+	if(!ok) return 0;
+
+	const size_t chunkSize = 1024 * 1024;
+	vector<unsigned char> buffer(chunkSize);
+	uint64_t h = 0;
+	while(file){
+		if(cancel && *cancel){
+			ok = false;
+			return 0;
+		}
+		file.read((char*)buffer.data(), chunkSize);
+		size_t n = file.gcount();
+		if(n == 0) break;
+		h = rotl64(h, 17) ^ hashBytes(buffer.data(), n);
+	}
+	return h;
+}
+
+
+bool ofxAnimationAssetManagerManifest::fillFrame(const string & folder, const string & name, Frame & f, const std::atomic<bool> * cancel){
+
+	f.name = name;
+	string sourcePath = folder + "/" + name;
+	if(!getFileStats(sourcePath, f.sourceSize, f.sourceModified)) return false;
+	int64_t dxtModified;
+	if(!getFileStats(sourcePath + ".dxt", f.dxtSize, dxtModified)) return false;
+	bool ok;
+	f.dxtHash = hashFile(sourcePath + ".dxt", ok, cancel);
+	return ok;
+}
+
+
+bool ofxAnimationAssetManagerManifest::haveSameContents(const string & pathA, const string & pathB){
+
+	std::ifstream a(pathA, std::ios::binary);
+	std::ifstream b(pathB, std::ios::binary);
+	if(!a.is_open() || !b.is_open()) return false;
+
+	const size_t chunkSize = 64 * 1024;
+	vector<char> bufferA(chunkSize), bufferB(chunkSize);
+	while(a && b){
+		a.read(bufferA.data(), chunkSize);
+		b.read(bufferB.data(), chunkSize);
+		if(a.gcount() != b.gcount()) return false;
+		if(memcmp(bufferA.data(), bufferB.data(), a.gcount()) != 0) return false;
+	}
+	return a.eof() && b.eof();
+}
+
+
+bool ofxAnimationAssetManagerManifest::isSameFile(const string & pathA, const string & pathB){
+
+	#if defined(TARGET_WIN32)
+	auto getId = [](const string & path, BY_HANDLE_FILE_INFORMATION & id){
+		HANDLE f = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(f == INVALID_HANDLE_VALUE) return false;
+		bool ok = GetFileInformationByHandle(f, &id) != 0;
+		CloseHandle(f);
+		return ok;
+	};
+	BY_HANDLE_FILE_INFORMATION a, b;
+	return getId(pathA, a) && getId(pathB, b) && a.dwVolumeSerialNumber == b.dwVolumeSerialNumber &&
+		   a.nFileIndexHigh == b.nFileIndexHigh && a.nFileIndexLow == b.nFileIndexLow;
+	#else
+	struct stat a, b;
+	return stat(pathA.c_str(), &a) == 0 && stat(pathB.c_str(), &b) == 0 && a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+	#endif
+}
+
+
+bool ofxAnimationAssetManagerManifest::linkFile(const string & from, const string & to){
+
+	//link under a temp name and swap it in, so "to" is never missing
+	string tempPath = to + ".link";
+	#if defined(TARGET_WIN32)
+	DeleteFileA(tempPath.c_str());
+	if(!CreateHardLinkA(tempPath.c_str(), from.c_str(), NULL)) return false;
+	if(!MoveFileExA(tempPath.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING)){
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	#else
+	if(isSameFile(from, to)) return true; //already linked
+	unlink(tempPath.c_str());
+	if(link(from.c_str(), tempPath.c_str()) != 0) return false;
+	if(std::rename(tempPath.c_str(), to.c_str()) != 0){
+		unlink(tempPath.c_str());
+		return false;
+	}
+	#endif
+	return true;
+}
+
+
+bool ofxAnimationAssetManagerManifest::dropFromCache(const string & path){
+
+	#if defined(TARGET_LINUX)
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0) return false;
+	fdatasync(fd); //dirty pages can't be dropped
+	bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+	return ok;
+	#else
+	return false;
+	#endif
+}
@@ -0,0 +1,73 @@
+//
+//  ofxAnimationAssetManagerManifest.h
+//  ofxAnimationAssetManager
+//
+//  Per-animation record of what was compressed: for each frame, the size and
+//  date of the source image and the size and content hash of its .dxt file.
+//  Animations baked with trimming also get each frame's alpha bounds and the
+//  canvas region all the .dxt files were cropped to.
+//  Written next to the frames after compression, so that the next launch can
+//  validate the whole DXT cache from one directory listing instead of
+//  poking at every single .dxt file.
+//
+//
+
+#pragma once
+#include "ofMain.h"
+
+class ofxAnimationAssetManagerManifest{
+
+public:
+
+	struct Rect{
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+		bool operator==(const Rect & o) const {return x == o.x && y == o.y && width == o.width && height == o.height;}
+	};
+
+	struct Frame{
+		string name;				//source image file name (ie "frame_001.png")
+		uint64_t sourceSize = 0;
+		int64_t sourceModified = 0;	//nanoseconds
+		uint64_t dxtSize = 0;
+		uint64_t dxtHash = 0;
+		bool hasAlphaBounds = false;//trimmed animations only
+		Rect alphaBounds;			//pixels with alpha > 0 (empty if fully transparent)
+	};
+
+	struct Trim{
+		bool enabled = false;
+		int canvasWidth = 0;		//size of the source images
+		int canvasHeight = 0;
+		Rect rect;					//region of the canvas the .dxt files hold (block aligned)
+	};
+
+	static const string fileName; //name of the manifest file inside the animation folder
+
+	bool load(const string & folder);
+	bool save(const string & folder);
+
+	const Frame * getFrame(const string & name) const;
+	void setFrame(const Frame & f);
+	const unordered_map<string, Frame> & getFrames() const {return frames;}
+	const Trim & getTrim() const {return trim;}
+	void setTrim(const Trim & t){trim = t;}
+
+	// FILE UTILS ////////////////////////////////////
+
+	static bool getFileStats(const string & path, uint64_t & size, int64_t & modified);
+	static uint64_t hashFile(const string & path, bool & ok, const std::atomic<bool> * cancel = nullptr); //ok is false if cancelled
+	static uint64_t hashBytes(const unsigned char * data, size_t len);
+	static bool fillFrame(const string & folder, const string & name, Frame & f, const std::atomic<bool> * cancel = nullptr); //stats source & .dxt, hashes the .dxt
+	static bool haveSameContents(const string & pathA, const string & pathB);
+	static bool isSameFile(const string & pathA, const string & pathB); //both paths are hard links to the same file
+	static bool linkFile(const string & from, const string & to); //replace "to" with a hard link to "from" (false if the filesystem can't)
+	static bool dropFromCache(const string & path); //evict the file from the OS page cache so the next read is cold (false if the OS can't)
+
+protected:
+
+	unordered_map<string, Frame> frames;
+	Trim trim;
+};
@@ -0,0 +1,129 @@
+//
+//  ofxAnimationAssetManagerStats.cpp
+//  ofxAnimationAssetManager
+//
+//
+
+#include "ofxAnimationAssetManagerStats.h"
+
+typedef ofxAnimationAssetManagerStats Stats;
+
+
+float Stats::Histogram::getMeanMs() const{
+	return count ? totalMicros / (1000.0f * count) : 0;
+}
+
+
+float Stats::Histogram::getPercentileMs(float p) const{
+
+	if(count == 0) return 0;
+	uint64_t target = std::max<uint64_t>(1, ceil(ofClamp(p, 0, 1) * count));
+	uint64_t acc = 0;
+	for(int i = 0; i < numBuckets; i++){
+		acc += buckets[i];
+		if(acc >= target){
+			return std::min<uint64_t>(uint64_t(1) << (i + 1), maxMicros) / 1000.0f;
+		}
+	}
+	return maxMicros / 1000.0f;
+}
+
+
+ofJson Stats::Histogram::toJson() const{
+
+	ofJson j;
+	j["count"] = count;
+	j["meanMs"] = getMeanMs();
+	j["p50Ms"] = getPercentileMs(0.5);
+	j["p90Ms"] = getPercentileMs(0.9);
+	j["p99Ms"] = getPercentileMs(0.99);
+	j["maxMs"] = maxMicros / 1000.0f;
+	//sparse, keyed by the bucket's upper edge in us
+	ofJson b = ofJson::object();
+	for(int i = 0; i < numBuckets; i++){
+		if(buckets[i]) b[ofToString(uint64_t(1) << (i + 1))] = buckets[i];
+	}
+	j["buckets"] = b;
+	return j;
+}
+
+
+void Stats::LatencyRecorder::add(uint64_t micros){
+
+	int bucket = 0;
+	while(bucket < Histogram::numBuckets - 1 && (micros >> (bucket + 1)) != 0){
+		bucket++;
+	}
+	buckets[bucket]++;
+	count++;
+	totalMicros += micros;
+	uint64_t prevMax = maxMicros;
+	while(micros > prevMax && !maxMicros.compare_exchange_weak(prevMax, micros)){}
+}
+
+
+Stats::Histogram Stats::LatencyRecorder::get() const{
+
+	Histogram h;
+	for(int i = 0; i < Histogram::numBuckets; i++){
+		h.buckets[i] = buckets[i];
+	}
+	h.count = count;
+	h.totalMicros = totalMicros;
+	h.maxMicros = maxMicros;
+	return h;
+}
+
+
+void Stats::LatencyRecorder::reset(){
+	for(auto & b : buckets) b = 0;
+	count = 0;
+	totalMicros = 0;
+	maxMicros = 0;
+}
+
+
+ofJson Stats::toJson(const Stage & s){
+	ofJson j;
+	j["wallMs"] = s.wallMs;
+	j["workerUtilization"] = s.workerUtilization;
+	j["peakQueuedJobs"] = s.peakQueuedJobs;
+	return j;
+}
+
+
+ofJson Stats::toJson() const{
+
+	ofJson j;
+	j["stages"]["checking"] = toJson(checking);
+	j["stages"]["compressing"] = toJson(compressing);
+	j["stages"]["preloading"] = toJson(preloading);
+	j["totalLoadMs"] = totalLoadMs;
+
+	ofJson a = ofJson::object();
+	for(auto & it : assets){
+		ofJson aj;
+		aj["bytesRead"] = it.second.bytesRead;
+		aj["bytesWritten"] = it.second.bytesWritten;
+		aj["framesCompressed"] = it.second.framesCompressed;
+		aj["checkMs"] = it.second.checkMs;
+		aj["compressMs"] = it.second.compressMs;
+		a[it.first] = aj;
+	}
+	j["assets"] = a;
+
+	j["latency"]["read"] = readLatency.toJson();
+	j["latency"]["decode"] = decodeLatency.toJson();
+	j["latency"]["encode"] = encodeLatency.toJson();
+	j["latency"]["write"] = writeLatency.toJson();
+	j["latency"]["upload"] = uploadLatency.toJson();
+
+	j["workers"]["numThreads"] = numThreads;
+	j["workers"]["queuedJobs"] = queuedJobs;
+	j["workers"]["activeJobs"] = activeJobs;
+	j["pipeline"]["readQueue"] = pipelineReadQueue;
+	j["pipeline"]["writeQueue"] = pipelineWriteQueue;
+	j["pipeline"]["framesInFlight"] = pipelineFramesInFlight;
+	j["pipeline"]["peakFramesInFlight"] = pipelinePeakFramesInFlight;
+	return j;
+}
@@ -0,0 +1,85 @@
+//
+//  ofxAnimationAssetManagerStats.h
+//  ofxAnimationAssetManager
+//
+//  Snapshot of the loading instrumentation, as returned by
+//  ofxAnimationAssetManager::getStats(): per stage wall times and worker
+//  utilization, per asset I/O and per frame latency histograms.
+//
+//
+
+#pragma once
+#include "ofMain.h"
+
+class ofxAnimationAssetManagerStats{
+
+public:
+
+	//log2 buckets over microseconds; bucket i counts samples in [2^i, 2^(i+1)) us (bucket 0 also takes 0us)
+	struct Histogram{
+		static const int numBuckets = 32;
+		uint64_t buckets[numBuckets] = {0};
+		uint64_t count = 0;
+		uint64_t totalMicros = 0;
+		uint64_t maxMicros = 0;
+
+		float getMeanMs() const;
+		float getPercentileMs(float p) const; //upper edge of the bucket holding the p (0..1) quantile
+		ofJson toJson() const;
+	};
+
+	//thread safe accumulator behind a Histogram, cheap enough to call from every worker
+	class LatencyRecorder{
+	public:
+		LatencyRecorder(){reset();}
+		void add(uint64_t micros);
+		Histogram get() const;
+		void reset();
+	protected:
+		std::atomic<uint64_t> buckets[Histogram::numBuckets];
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> totalMicros;
+		std::atomic<uint64_t> maxMicros;
+	};
+
+	struct Stage{
+		float wallMs = 0;
+		float workerUtilization = 0;	//time the worker pool spent running jobs / (wallMs * numThreads)
+		int peakQueuedJobs = 0;			//deepest the worker pool queue got
+	};
+
+	struct Asset{
+		uint64_t bytesRead = 0;			//source images, hashed .dxt files
+		uint64_t bytesWritten = 0;		//.dxt files
+		int framesCompressed = 0;
+		float checkMs = 0;
+		float compressMs = 0;
+	};
+
+	//stages, filled in as they end (the current one shows its running values)
+	Stage checking;
+	Stage compressing;
+	Stage preloading;
+	float totalLoadMs = 0; //startLoading() to READY
+
+	map<string, Asset> assets;
+
+	//per frame latencies
+	Histogram readLatency;		//source image file read (compression)
+	Histogram decodeLatency;	//image decode (compression & static images)
+	Histogram encodeLatency;	//DXT encode
+	Histogram writeLatency;		//.dxt file write
+	Histogram uploadLatency;	//static image GL upload
+
+	//worker pool & compression pipeline, right now
+	int numThreads = 0;
+	int queuedJobs = 0;
+	int activeJobs = 0;
+	int pipelineReadQueue = 0;		//frames waiting to be read
+	int pipelineWriteQueue = 0;		//frames waiting to be written
+	int pipelineFramesInFlight = 0;
+	int pipelinePeakFramesInFlight = 0;
+
+	ofJson toJson() const;
+	static ofJson toJson(const Stage & s);
+};
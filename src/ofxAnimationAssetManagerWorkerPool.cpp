@@ -0,0 +1,164 @@
+//
+//  ofxAnimationAssetManagerWorkerPool.cpp
+//  ofxAnimationAssetManager
+//
+//
+
+#include "ofxAnimationAssetManagerWorkerPool.h"
+
+//which pool / queue the current thread works for (if any)
+static thread_local ofxAnimationAssetManagerWorkerPool * currentPool = nullptr;
+static thread_local int currentQueue = -1;
+
+
+ofxAnimationAssetManagerWorkerPool::~ofxAnimationAssetManagerWorkerPool(){
+	stop();
+}
+
+
+void ofxAnimationAssetManagerWorkerPool::setup(int numThreads){
+
+	if(threads.size()){
+		ofLogError("ofxAnimationAssetManagerWorkerPool") << "setup() called twice! ignoring.";
+		return;
+	}
+	numThreads = std::max(numThreads, 1);
+	stopping = false;
+	queues.clear();
+	for(int i = 0; i < numThreads; i++){
+		queues.emplace_back(new WorkerQueue());
+	}
+	for(int i = 0; i < numThreads; i++){
+		threads.emplace_back(&ofxAnimationAssetManagerWorkerPool::threadLoop, this, i);
+	}
+}
+
+
+void ofxAnimationAssetManagerWorkerPool::stop(){
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	for(auto & q : queues){
+		std::lock_guard<std::mutex> lock(q->mutex);
+		q->jobs.clear();
+	}
+	numQueuedJobs = 0;
+	jobAvailable.notify_all();
+	for(auto & t : threads){
+		if(t.joinable()) t.join();
+	}
+	threads.clear();
+}
+
+
+void ofxAnimationAssetManagerWorkerPool::cancelPending(){
+
+	//running jobs can submit more, so keep going until it all settles
+	while(true){
+		int dropped = 0;
+		for(auto & q : queues){
+			std::lock_guard<std::mutex> lock(q->mutex);
+			dropped += q->jobs.size();
+			q->jobs.clear();
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		numQueuedJobs -= dropped;
+		jobFinished.wait(lock, [this]{ return numActiveJobs == 0; });
+
+		bool empty = true;
+		for(auto & q : queues){
+			std::lock_guard<std::mutex> qlock(q->mutex);
+			empty &= q->jobs.empty();
+		}
+		if(empty) return;
+	}
+}
+
+
+void ofxAnimationAssetManagerWorkerPool::submit(std::function<void()> job){
+
+	if(queues.size() == 0){
+		ofLogError("ofxAnimationAssetManagerWorkerPool") << "submit() called before setup()! ignoring job.";
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		if(stopping) return;
+	}
+
+	int index;
+	if(currentPool == this){ //submitted from one of our workers, keep it local
+		index = currentQueue;
+	}else{
+		index = nextQueue++ % queues.size();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->jobs.emplace_back(std::move(job));
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		int n = ++numQueuedJobs;
+		if(n > peakQueuedJobs) peakQueuedJobs = n; //only written under sleepMutex
+	}
+	jobAvailable.notify_one();
+}
+
+
+bool ofxAnimationAssetManagerWorkerPool::popJob(int index, std::function<void()> & job){
+
+	{ //own queue, newest first
+		WorkerQueue & q = *queues[index];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if(q.jobs.size()){
+			job = std::move(q.jobs.back());
+			q.jobs.pop_back();
+			numActiveJobs++; //while still holding the queue lock, so cancelPending() can't miss it
+			return true;
+		}
+	}
+
+	//steal the oldest job from someone else
+	for(size_t i = 1; i < queues.size(); i++){
+		WorkerQueue & q = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if(q.jobs.size()){
+			job = std::move(q.jobs.front());
+			q.jobs.pop_front();
+			numActiveJobs++;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void ofxAnimationAssetManagerWorkerPool::threadLoop(int index){
+
+	currentPool = this;
+	currentQueue = index;
+
+	while(true){
+		std::function<void()> job;
+		if(popJob(index, job)){
+			numQueuedJobs--;
+			uint64_t start = ofGetElapsedTimeMicros();
+			job();
+			job = nullptr; //release whatever it captured before reporting it done
+			busyMicros += ofGetElapsedTimeMicros() - start;
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				numActiveJobs--;
+			}
+			jobFinished.notify_all();
+		}else{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			jobAvailable.wait(lock, [this]{ return stopping || numQueuedJobs > 0; });
+			if(stopping) return;
+		}
+	}
+}
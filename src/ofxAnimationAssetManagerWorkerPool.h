@@ -0,0 +1,62 @@
+//
+//  ofxAnimationAssetManagerWorkerPool.h
+//  ofxAnimationAssetManager
+//
+//  Long-lived pool of worker threads shared by all the background
+//  stages of ofxAnimationAssetManager (checking, compressing, etc).
+//
+//  Each worker owns a job deque. Jobs submitted from a worker thread go
+//  to that worker's own deque (and are popped LIFO by it), while idle
+//  workers steal from the front of the other deques. This keeps all
+//  threads busy when one big job fans out into many small ones.
+//
+
+#pragma once
+#include "ofMain.h"
+
+class ofxAnimationAssetManagerWorkerPool{
+
+public:
+
+	~ofxAnimationAssetManagerWorkerPool();
+
+	void setup(int numThreads); //spawns the worker threads, call once
+	void stop(); //drops all queued jobs, waits for the running ones to end and joins all threads
+	void cancelPending(); //drops all queued jobs and waits for the running ones to end; threads stay up. Not from a worker!
+
+	//queue a job to be run on any of the worker threads
+	void submit(std::function<void()> job);
+
+	int getNumThreads(){return threads.size();}
+	size_t getNumQueuedJobs(){return std::max(0, numQueuedJobs.load());}
+	int getNumActiveJobs(){return numActiveJobs;}
+
+	//instrumentation
+	uint64_t getBusyMicros(){return busyMicros;} //time spent running jobs, summed over all threads
+	int getPeakQueuedJobs(){return peakQueuedJobs;}
+	void resetPeakQueuedJobs(){peakQueuedJobs = 0;}
+
+protected:
+
+	struct WorkerQueue{
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	void threadLoop(int index);
+	bool popJob(int index, std::function<void()> & job); //own queue first, then steal from others
+
+	vector<std::thread> threads;
+	vector<unique_ptr<WorkerQueue>> queues; //one per thread
+
+	std::mutex sleepMutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobFinished; //for cancelPending()
+	bool stopping = false;
+
+	std::atomic<int> numQueuedJobs{0}; //can briefly dip below 0 while a job is being pushed
+	std::atomic<int> numActiveJobs{0};
+	std::atomic<int> peakQueuedJobs{0};
+	std::atomic<uint64_t> busyMicros{0};
+	std::atomic<unsigned int> nextQueue{0}; //round robin for jobs submitted from outside the pool
+};